@@ -0,0 +1,78 @@
+#ifndef JNSTL_BENCH_BENCH_UTIL_H_
+#define JNSTL_BENCH_BENCH_UTIL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+/* A 64 bytes element, expensive to copy compared to its comparison. */
+struct Large {
+  uint64_t key;
+  uint64_t payload[7];
+
+  bool operator<(const Large& rhs) const {
+    return key < rhs.key;
+  }
+
+  bool operator==(const Large& rhs) const {
+    return key == rhs.key;
+  }
+};
+
+template <typename T>
+T MakeValue(uint64_t x);
+
+template <>
+inline int MakeValue<int>(uint64_t x) {
+  return static_cast<int>(x);
+}
+
+template <>
+inline double MakeValue<double>(uint64_t x) {
+  return static_cast<double>(x) * 0.5;
+}
+
+/* Long enough to defeat the small string optimization. */
+template <>
+inline std::string MakeValue<std::string>(uint64_t x) {
+  char buffer[48];
+  std::snprintf(buffer, sizeof(buffer), "key-%032llu",
+                static_cast<unsigned long long>(x));
+  return std::string(buffer);
+}
+
+template <>
+inline Large MakeValue<Large>(uint64_t x) {
+  Large value;
+  value.key = x;
+  for (size_t i = 0; i < 7; ++i)
+    value.payload[i] = x + i;
+  return value;
+}
+
+/* n values in random order, identical from one run to the other. */
+template <typename T>
+std::vector<T> RandomValues(size_t n, uint64_t seed = 42) {
+  std::mt19937_64 rng(seed);
+  std::vector<T> values;
+  values.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+    values.push_back(MakeValue<T>(rng()));
+  return values;
+}
+
+template <typename T>
+std::vector<T> SortedValues(size_t n) {
+  std::vector<T> values;
+  values.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+    values.push_back(MakeValue<T>(i));
+  return values;
+}
+}  // namespace bench
+
+#endif /* JNSTL_BENCH_BENCH_UTIL_H_ */
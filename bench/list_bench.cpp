@@ -0,0 +1,60 @@
+#include <list>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "JNSTL/list.h"
+
+#include "bench_util.h"
+
+namespace {
+template <typename List>
+void BM_ListSort(benchmark::State& state) {
+  typedef typename List::value_type T;
+  const std::vector<T> values = bench::RandomValues<T>(state.range(0));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    List l(values.begin(), values.end());
+    state.ResumeTiming();
+
+    l.sort();
+    benchmark::DoNotOptimize(&l.front());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/* Moves every element, one at a time, from the front of a list to the
+   middle of another one, then back. */
+template <typename List>
+void BM_ListSplice(benchmark::State& state) {
+  typedef typename List::value_type T;
+  const std::vector<T> values = bench::RandomValues<T>(state.range(0));
+  List a(values.begin(), values.end());
+  List b;
+
+  for (auto _ : state) {
+    typename List::iterator middle = b.begin();
+    while (!a.empty())
+      b.splice(middle, a, a.begin());
+    while (!b.empty())
+      a.splice(a.end(), b, b.begin());
+    benchmark::DoNotOptimize(&a.front());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+#define JNSTL_LIST_BENCH(Func, T, MaxSize)                                    \
+  BENCHMARK_TEMPLATE(Func, jnstl::list<T>)->RangeMultiplier(8)                \
+      ->Range(8, MaxSize);                                                    \
+  BENCHMARK_TEMPLATE(Func, std::list<T>)->RangeMultiplier(8)                  \
+      ->Range(8, MaxSize)
+
+JNSTL_LIST_BENCH(BM_ListSort, int, 1 << 18);
+JNSTL_LIST_BENCH(BM_ListSort, std::string, 1 << 15);
+JNSTL_LIST_BENCH(BM_ListSort, bench::Large, 1 << 15);
+
+JNSTL_LIST_BENCH(BM_ListSplice, int, 1 << 18);
+JNSTL_LIST_BENCH(BM_ListSplice, std::string, 1 << 15);
+}  // namespace
@@ -0,0 +1,104 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "JNSTL/map.h"
+
+#include "bench_util.h"
+
+namespace {
+template <typename Map>
+void BM_MapInsert(benchmark::State& state) {
+  typedef typename Map::key_type   Key;
+  typedef typename Map::value_type Value;
+  const std::vector<Key> keys = bench::RandomValues<Key>(state.range(0));
+
+  for (auto _ : state) {
+    Map m;
+    for (size_t i = 0; i < keys.size(); ++i)
+      m.insert(Value(keys[i], static_cast<int>(i)));
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/* Half of the lookups hit. */
+template <typename Map>
+void BM_MapFind(benchmark::State& state) {
+  typedef typename Map::key_type   Key;
+  typedef typename Map::value_type Value;
+  const std::vector<Key> keys = bench::RandomValues<Key>(state.range(0));
+  const std::vector<Key> misses = bench::RandomValues<Key>(state.range(0), 7);
+
+  Map m;
+  for (size_t i = 0; i < keys.size(); i += 2)
+    m.insert(Value(keys[i], static_cast<int>(i)));
+
+  for (auto _ : state) {
+    size_t found = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+      found += (m.find((i & 1) ? misses[i] : keys[i]) != m.end());
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Map>
+void BM_MapErase(benchmark::State& state) {
+  typedef typename Map::key_type   Key;
+  typedef typename Map::value_type Value;
+  const std::vector<Key> keys = bench::RandomValues<Key>(state.range(0));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    Map m;
+    for (size_t i = 0; i < keys.size(); ++i)
+      m.insert(Value(keys[i], static_cast<int>(i)));
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < keys.size(); ++i)
+      m.erase(keys[i]);
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Map>
+void BM_MapIterate(benchmark::State& state) {
+  typedef typename Map::key_type   Key;
+  typedef typename Map::value_type Value;
+  const std::vector<Key> keys = bench::RandomValues<Key>(state.range(0));
+
+  Map m;
+  for (size_t i = 0; i < keys.size(); ++i)
+    m.insert(Value(keys[i], static_cast<int>(i)));
+
+  for (auto _ : state) {
+    long sum = 0;
+    for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+      sum += (*it).second;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * m.size());
+}
+
+#define JNSTL_MAP_BENCH(Func, Key, MaxSize)                                   \
+  BENCHMARK_TEMPLATE(Func, jnstl::map<Key, int>)->RangeMultiplier(8)          \
+      ->Range(8, MaxSize);                                                    \
+  BENCHMARK_TEMPLATE(Func, std::map<Key, int>)->RangeMultiplier(8)            \
+      ->Range(8, MaxSize)
+
+JNSTL_MAP_BENCH(BM_MapInsert, int, 1 << 18);
+JNSTL_MAP_BENCH(BM_MapInsert, std::string, 1 << 15);
+
+JNSTL_MAP_BENCH(BM_MapFind, int, 1 << 18);
+JNSTL_MAP_BENCH(BM_MapFind, std::string, 1 << 15);
+
+JNSTL_MAP_BENCH(BM_MapErase, int, 1 << 18);
+JNSTL_MAP_BENCH(BM_MapErase, std::string, 1 << 15);
+
+JNSTL_MAP_BENCH(BM_MapIterate, int, 1 << 18);
+JNSTL_MAP_BENCH(BM_MapIterate, std::string, 1 << 15);
+}  // namespace
@@ -0,0 +1,181 @@
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// queue.h relies on its users to include the underlying containers
+#include "JNSTL/algorithm.h"
+#include "JNSTL/deque.h"
+#include "JNSTL/list.h"
+#include "JNSTL/vector.h"
+#include "JNSTL/queue.h"
+
+#include "bench_util.h"
+
+namespace {
+/* Heaps of 4 and 8 children per node */
+template <typename T>
+using QuaternaryQueue =
+    jnstl::priority_queue<T, jnstl::vector<T>, std::less<T>, 4>;
+template <typename T>
+using OctonaryQueue =
+    jnstl::priority_queue<T, jnstl::vector<T>, std::less<T>, 8>;
+
+/* Pushes n elements then pops them all. */
+template <typename PriorityQueue>
+void BM_PriorityQueuePushPop(benchmark::State& state) {
+  typedef typename PriorityQueue::value_type T;
+  const std::vector<T> values = bench::RandomValues<T>(state.range(0));
+
+  for (auto _ : state) {
+    PriorityQueue pq;
+    for (const T& x : values)
+      pq.push(x);
+    while (!pq.empty())
+      pq.pop();
+    benchmark::DoNotOptimize(pq.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define JNSTL_QUEUE_BENCH(Func, T, MaxSize)                                   \
+  BENCHMARK_TEMPLATE(Func, jnstl::priority_queue<T>)->RangeMultiplier(8)      \
+      ->Range(8, MaxSize);                                                    \
+  BENCHMARK_TEMPLATE(Func, QuaternaryQueue<T>)->RangeMultiplier(8)            \
+      ->Range(8, MaxSize);                                                    \
+  BENCHMARK_TEMPLATE(Func, OctonaryQueue<T>)->RangeMultiplier(8)              \
+      ->Range(8, MaxSize);                                                    \
+  BENCHMARK_TEMPLATE(Func, std::priority_queue<T>)->RangeMultiplier(8)        \
+      ->Range(8, MaxSize)
+
+JNSTL_QUEUE_BENCH(BM_PriorityQueuePushPop, int, 1 << 18);
+JNSTL_QUEUE_BENCH(BM_PriorityQueuePushPop, double, 1 << 18);
+JNSTL_QUEUE_BENCH(BM_PriorityQueuePushPop, std::string, 1 << 15);
+JNSTL_QUEUE_BENCH(BM_PriorityQueuePushPop, bench::Large, 1 << 15);
+
+/* n keys, each lowered 4 times in random order, then all popped: a
+   min-queue where stale entries are pushed again and skipped when they come
+   out, against one changing its entries in place. */
+typedef std::pair<uint64_t, size_t> KeyEntry;
+
+void BM_LazyDecreaseKey(benchmark::State& state) {
+  const size_t n = state.range(0);
+  const std::vector<int> values = bench::RandomValues<int>(5 * n);
+
+  for (auto _ : state) {
+    jnstl::priority_queue<KeyEntry, jnstl::vector<KeyEntry>,
+                          std::greater<KeyEntry>> pq;
+    std::vector<uint64_t> keys(n, UINT64_MAX);
+    size_t popped = 0;
+
+    for (size_t i = 0; i < values.size(); ++i) {
+      const size_t id = i % n;
+      const uint64_t key = keys[id] - (static_cast<uint32_t>(values[i]) >> 4);
+      keys[id] = key;
+      pq.push(KeyEntry(key, id));
+    }
+    while (!pq.empty()) {
+      const KeyEntry top = pq.top();
+      pq.pop();
+      popped += top.first == keys[top.second];
+    }
+    benchmark::DoNotOptimize(popped);
+  }
+  state.SetItemsProcessed(state.iterations() * 5 * n);
+}
+
+void BM_IndexedDecreaseKey(benchmark::State& state) {
+  const size_t n = state.range(0);
+  const std::vector<int> values = bench::RandomValues<int>(5 * n);
+
+  for (auto _ : state) {
+    jnstl::indexed_priority_queue<uint64_t, std::greater<uint64_t>> pq;
+    std::vector<size_t> handles(n);
+    size_t popped = 0;
+
+    for (size_t i = 0; i < values.size(); ++i) {
+      const size_t id = i % n;
+      const uint64_t delta = static_cast<uint32_t>(values[i]) >> 4;
+      if (i < n)
+        handles[id] = pq.push(UINT64_MAX - delta);
+      else
+        pq.decrease_key(handles[id], pq[handles[id]] - delta);
+    }
+    while (!pq.empty()) {
+      pq.pop();
+      ++popped;
+    }
+    benchmark::DoNotOptimize(popped);
+  }
+  state.SetItemsProcessed(state.iterations() * 5 * n);
+}
+
+BENCHMARK(BM_LazyDecreaseKey)->RangeMultiplier(8)->Range(8, 1 << 18);
+BENCHMARK(BM_IndexedDecreaseKey)->RangeMultiplier(8)->Range(8, 1 << 18);
+
+/* Event simulation: n pending timestamps, every event popped schedules
+   another one a random delay later, 4 n times. */
+template <typename MinQueue>
+void BM_MonotoneHold(benchmark::State& state) {
+  const size_t n = state.range(0);
+  const std::vector<int> delays = bench::RandomValues<int>(5 * n);
+
+  for (auto _ : state) {
+    MinQueue pq;
+    uint64_t now = 0;
+
+    for (size_t i = 0; i < n; ++i)
+      pq.push(static_cast<uint32_t>(delays[i]) >> 8);
+    for (size_t i = n; i < delays.size(); ++i) {
+      now = pq.top();
+      pq.pop();
+      pq.push(now + (static_cast<uint32_t>(delays[i]) >> 8));
+    }
+    benchmark::DoNotOptimize(now);
+  }
+  state.SetItemsProcessed(state.iterations() * 4 * n);
+}
+
+typedef jnstl::priority_queue<uint64_t, jnstl::vector<uint64_t>,
+                              std::greater<uint64_t>> BinaryMinQueue;
+
+BENCHMARK_TEMPLATE(BM_MonotoneHold, jnstl::radix_heap<uint64_t>)
+    ->RangeMultiplier(8)->Range(8, 1 << 18);
+BENCHMARK_TEMPLATE(BM_MonotoneHold, BinaryMinQueue)
+    ->RangeMultiplier(8)->Range(8, 1 << 18);
+
+/* A FIFO holding n elements: every element popped from the front is pushed
+   back, 4 n times. */
+template <typename Queue>
+void BM_QueueRotate(benchmark::State& state) {
+  typedef typename Queue::value_type T;
+  const std::vector<T> values = bench::RandomValues<T>(state.range(0));
+
+  for (auto _ : state) {
+    Queue q;
+    for (const T& x : values)
+      q.push(x);
+    for (size_t i = 0; i < 4 * values.size(); ++i) {
+      q.push(q.front());
+      q.pop();
+    }
+    benchmark::DoNotOptimize(&q.front());
+  }
+  state.SetItemsProcessed(state.iterations() * 5 * state.range(0));
+}
+
+#define JNSTL_FIFO_BENCH(Func, T, MaxSize)                                    \
+  BENCHMARK_TEMPLATE(Func, jnstl::queue<T>)->RangeMultiplier(8)               \
+      ->Range(8, MaxSize);                                                    \
+  BENCHMARK_TEMPLATE(Func, jnstl::queue<T, jnstl::list<T>>)                   \
+      ->RangeMultiplier(8)->Range(8, MaxSize);                                \
+  BENCHMARK_TEMPLATE(Func, std::queue<T>)->RangeMultiplier(8)                 \
+      ->Range(8, MaxSize)
+
+JNSTL_FIFO_BENCH(BM_QueueRotate, int, 1 << 18);
+JNSTL_FIFO_BENCH(BM_QueueRotate, std::string, 1 << 15);
+}  // namespace
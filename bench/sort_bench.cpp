@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "JNSTL/algorithm.h"
+#include "JNSTL/parallel_algorithm.h"
+
+#include "bench_util.h"
+
+namespace {
+enum Pattern {
+  kRandom,
+  kSorted,
+  kReversed,
+  kFewUnique
+};
+
+template <typename T>
+std::vector<T> MakeInput(size_t n, int pattern) {
+  std::vector<T> values;
+
+  switch (pattern) {
+    case kSorted:
+      return bench::SortedValues<T>(n);
+    case kReversed:
+      values = bench::SortedValues<T>(n);
+      std::reverse(values.begin(), values.end());
+      return values;
+    case kFewUnique:
+      for (size_t i = 0; i < n; ++i)
+        values.push_back(bench::MakeValue<T>((i * 7919) % 16));
+      return values;
+    default:
+      return bench::RandomValues<T>(n);
+  }
+}
+
+struct JnstlSort {
+  template <typename It>
+  static void Run(It first, It last) { jnstl::sort(first, last); }
+};
+
+struct StdSort {
+  template <typename It>
+  static void Run(It first, It last) { std::sort(first, last); }
+};
+
+struct JnstlStableSort {
+  template <typename It>
+  static void Run(It first, It last) { jnstl::stable_sort(first, last); }
+};
+
+struct StdStableSort {
+  template <typename It>
+  static void Run(It first, It last) { std::stable_sort(first, last); }
+};
+
+struct JnstlRadixSort {
+  template <typename It>
+  static void Run(It first, It last) { jnstl::radix_sort(first, last); }
+};
+
+struct JnstlParallelSort {
+  template <typename It>
+  static void Run(It first, It last) { jnstl::parallel_sort(first, last); }
+};
+
+struct JnstlParallelStableSort {
+  template <typename It>
+  static void Run(It first, It last) {
+    jnstl::parallel_stable_sort(first, last);
+  }
+};
+
+/* Descending order, the runs are merged in the opposite direction. */
+struct JnstlParallelStableSortDescending {
+  template <typename It>
+  static void Run(It first, It last) {
+    typedef typename std::iterator_traits<It>::value_type T;
+    jnstl::parallel_stable_sort(first, last, std::greater<T>());
+  }
+};
+
+struct StdStableSortDescending {
+  template <typename It>
+  static void Run(It first, It last) {
+    typedef typename std::iterator_traits<It>::value_type T;
+    std::stable_sort(first, last, std::greater<T>());
+  }
+};
+
+/* Sorts the smallest tenth of the range. */
+struct JnstlPartialSort {
+  template <typename It>
+  static void Run(It first, It last) {
+    jnstl::partial_sort(first, first + (last - first) / 10, last);
+  }
+};
+
+struct StdPartialSort {
+  template <typename It>
+  static void Run(It first, It last) {
+    std::partial_sort(first, first + (last - first) / 10, last);
+  }
+};
+
+/* Sorts the 100 smallest elements. */
+struct JnstlTopK {
+  template <typename It>
+  static void Run(It first, It last) {
+    jnstl::partial_sort(first, first + std::min<ptrdiff_t>(last - first, 100),
+                        last);
+  }
+};
+
+struct StdTopK {
+  template <typename It>
+  static void Run(It first, It last) {
+    std::partial_sort(first, first + std::min<ptrdiff_t>(last - first, 100),
+                      last);
+  }
+};
+
+/* Selects the median. */
+struct JnstlNthElement {
+  template <typename It>
+  static void Run(It first, It last) {
+    jnstl::nth_element(first, first + (last - first) / 2, last);
+  }
+};
+
+struct StdNthElement {
+  template <typename It>
+  static void Run(It first, It last) {
+    std::nth_element(first, first + (last - first) / 2, last);
+  }
+};
+
+/* range(0) is the size, range(1) the input pattern. */
+template <typename Sorter, typename T>
+void BM_Sort(benchmark::State& state) {
+  const std::vector<T> input = MakeInput<T>(state.range(0),
+                                            static_cast<int>(state.range(1)));
+  std::vector<T> values;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    values = input;
+    state.ResumeTiming();
+
+    Sorter::Run(values.data(), values.data() + values.size());
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void SortArguments(benchmark::internal::Benchmark* b, int maxSize) {
+  for (int n = 8; n <= maxSize; n *= 8) {
+    for (int pattern = kRandom; pattern <= kFewUnique; ++pattern)
+      b->Args({n, pattern});
+  }
+}
+
+void SmallSortArguments(benchmark::internal::Benchmark* b) {
+  SortArguments(b, 1 << 15);
+}
+
+void LargeSortArguments(benchmark::internal::Benchmark* b) {
+  SortArguments(b, 1 << 21);
+}
+
+#define JNSTL_SORT_BENCH(JnstlSorter, StdSorter, T, Arguments)               \
+  BENCHMARK_TEMPLATE(BM_Sort, JnstlSorter, T)->Apply(Arguments);             \
+  BENCHMARK_TEMPLATE(BM_Sort, StdSorter, T)->Apply(Arguments)
+
+/* range(0) sorted runs of range(1) elements each. */
+template <typename T>
+std::vector<std::vector<T> > MakeRuns(size_t runs, size_t length) {
+  const std::vector<T> values = bench::RandomValues<T>(runs * length);
+  std::vector<std::vector<T> > result(runs);
+
+  for (size_t r = 0; r < runs; ++r) {
+    result[r].assign(values.begin() + r * length,
+                     values.begin() + (r + 1) * length);
+    std::sort(result[r].begin(), result[r].end());
+  }
+  return result;
+}
+
+struct JnstlMultiwayMerge {
+  template <typename T>
+  static void Run(const std::vector<std::vector<T> >& runs,
+                  std::vector<T>& out) {
+    std::vector<std::pair<const T*, const T*> > ranges;
+    for (size_t r = 0; r < runs.size(); ++r)
+      ranges.push_back(std::make_pair(runs[r].data(),
+                                      runs[r].data() + runs[r].size()));
+    jnstl::multiway_merge(ranges.begin(), ranges.end(), out.begin());
+  }
+};
+
+struct JnstlParallelMultiwayMerge {
+  template <typename T>
+  static void Run(const std::vector<std::vector<T> >& runs,
+                  std::vector<T>& out) {
+    std::vector<std::pair<const T*, const T*> > ranges;
+    for (size_t r = 0; r < runs.size(); ++r)
+      ranges.push_back(std::make_pair(runs[r].data(),
+                                      runs[r].data() + runs[r].size()));
+    jnstl::parallel_multiway_merge(ranges.begin(), ranges.end(),
+                                   out.begin());
+  }
+};
+
+/* Pairwise std::merge rounds, each element being copied log2(k) times.
+   The last round writes to out. */
+struct StdChainedMerge {
+  template <typename T>
+  static void Run(const std::vector<std::vector<T> >& runs,
+                  std::vector<T>& out) {
+    const std::vector<std::vector<T> >* level = &runs;
+    std::vector<std::vector<T> > merged;
+
+    while (level->size() > 2) {
+      std::vector<std::vector<T> > next;
+      for (size_t r = 0; r + 1 < level->size(); r += 2) {
+        const std::vector<T>& a = (*level)[r];
+        const std::vector<T>& b = (*level)[r + 1];
+        next.push_back(std::vector<T>(a.size() + b.size()));
+        std::merge(a.begin(), a.end(), b.begin(), b.end(),
+                   next.back().begin());
+      }
+      if (level->size() % 2)
+        next.push_back(level->back());
+      merged.swap(next);
+      level = &merged;
+    }
+    std::merge((*level)[0].begin(), (*level)[0].end(), (*level)[1].begin(),
+               (*level)[1].end(), out.begin());
+  }
+};
+
+template <typename Merger, typename T>
+void BM_MultiwayMerge(benchmark::State& state) {
+  const std::vector<std::vector<T> > runs =
+      MakeRuns<T>(state.range(0), state.range(1));
+  std::vector<T> out(state.range(0) * state.range(1));
+
+  for (auto _ : state) {
+    Merger::Run(runs, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+void MultiwayMergeArguments(benchmark::internal::Benchmark* b) {
+  for (int runs = 2; runs <= 256; runs *= 4)
+    b->Args({runs, (1 << 20) / runs});
+}
+
+#define JNSTL_MERGE_BENCH(Merger, T)                                          \
+  BENCHMARK_TEMPLATE(BM_MultiwayMerge, Merger, T)                             \
+      ->Apply(MultiwayMergeArguments)
+
+JNSTL_MERGE_BENCH(JnstlMultiwayMerge, int);
+JNSTL_MERGE_BENCH(JnstlParallelMultiwayMerge, int);
+JNSTL_MERGE_BENCH(StdChainedMerge, int);
+JNSTL_MERGE_BENCH(JnstlMultiwayMerge, std::string);
+JNSTL_MERGE_BENCH(StdChainedMerge, std::string);
+
+JNSTL_SORT_BENCH(JnstlSort, StdSort, int, LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlSort, StdSort, double, LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlSort, StdSort, std::string, SmallSortArguments);
+JNSTL_SORT_BENCH(JnstlSort, StdSort, bench::Large, SmallSortArguments);
+
+JNSTL_SORT_BENCH(JnstlStableSort, StdStableSort, int, LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlStableSort, StdStableSort, double, LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlStableSort, StdStableSort, std::string,
+                 SmallSortArguments);
+JNSTL_SORT_BENCH(JnstlStableSort, StdStableSort, bench::Large,
+                 SmallSortArguments);
+
+JNSTL_SORT_BENCH(JnstlRadixSort, StdSort, int, LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlRadixSort, StdSort, double, LargeSortArguments);
+
+JNSTL_SORT_BENCH(JnstlParallelSort, StdSort, int, LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlParallelStableSort, StdStableSort, int,
+                 LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlParallelStableSort, StdStableSort, std::string,
+                 LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlParallelStableSortDescending, StdStableSortDescending,
+                 std::string, LargeSortArguments);
+
+JNSTL_SORT_BENCH(JnstlPartialSort, StdPartialSort, int, LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlPartialSort, StdPartialSort, std::string,
+                 SmallSortArguments);
+
+JNSTL_SORT_BENCH(JnstlTopK, StdTopK, int, LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlTopK, StdTopK, double, LargeSortArguments);
+
+JNSTL_SORT_BENCH(JnstlNthElement, StdNthElement, int, LargeSortArguments);
+JNSTL_SORT_BENCH(JnstlNthElement, StdNthElement, std::string,
+                 SmallSortArguments);
+}  // namespace
@@ -0,0 +1,74 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "JNSTL/vector.h"
+
+#include "bench_util.h"
+
+namespace {
+template <typename Vector>
+void BM_VectorPushBack(benchmark::State& state) {
+  typedef typename Vector::value_type T;
+  const std::vector<T> values = bench::RandomValues<T>(state.range(0));
+
+  for (auto _ : state) {
+    Vector v;
+    for (const T& x : values)
+      v.push_back(x);
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/* Inserts each value in the middle, O(n^2) element moves in total. */
+template <typename Vector>
+void BM_VectorInsertMiddle(benchmark::State& state) {
+  typedef typename Vector::value_type T;
+  const std::vector<T> values = bench::RandomValues<T>(state.range(0));
+
+  for (auto _ : state) {
+    Vector v;
+    for (const T& x : values)
+      v.insert(v.begin() + v.size() / 2, x);
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Vector>
+void BM_VectorEraseMiddle(benchmark::State& state) {
+  typedef typename Vector::value_type T;
+  const std::vector<T> values = bench::RandomValues<T>(state.range(0));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    Vector v(values.data(), values.data() + values.size());
+    state.ResumeTiming();
+
+    while (!v.empty())
+      v.erase(v.begin() + v.size() / 2);
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define JNSTL_VECTOR_BENCH(Func, T, MaxSize)                                  \
+  BENCHMARK_TEMPLATE(Func, jnstl::vector<T>)->RangeMultiplier(8)              \
+      ->Range(8, MaxSize);                                                    \
+  BENCHMARK_TEMPLATE(Func, std::vector<T>)->RangeMultiplier(8)                \
+      ->Range(8, MaxSize)
+
+JNSTL_VECTOR_BENCH(BM_VectorPushBack, int, 1 << 18);
+JNSTL_VECTOR_BENCH(BM_VectorPushBack, std::string, 1 << 15);
+JNSTL_VECTOR_BENCH(BM_VectorPushBack, bench::Large, 1 << 15);
+
+JNSTL_VECTOR_BENCH(BM_VectorInsertMiddle, int, 1 << 12);
+JNSTL_VECTOR_BENCH(BM_VectorInsertMiddle, std::string, 1 << 12);
+JNSTL_VECTOR_BENCH(BM_VectorInsertMiddle, bench::Large, 1 << 12);
+
+JNSTL_VECTOR_BENCH(BM_VectorEraseMiddle, int, 1 << 12);
+JNSTL_VECTOR_BENCH(BM_VectorEraseMiddle, std::string, 1 << 12);
+JNSTL_VECTOR_BENCH(BM_VectorEraseMiddle, bench::Large, 1 << 12);
+}  // namespace
@@ -7,11 +7,19 @@
 #include <limits>
 #include <functional>
 #include <cmath>
+#include <iterator>
+#include <type_traits>
 
 #include "JNSTL/bits/config.h"
 #include "JNSTL/bits/tempbuf.h"
 #include "JNSTL/bits/heap.h"
 #include "JNSTL/bits/sort.h"
+#include "JNSTL/bits/merge_sort.h"
+#include "JNSTL/bits/multiway_merge.h"
+#include "JNSTL/bits/radix_sort.h"
+#include "JNSTL/bits/select.h"
+#include "JNSTL/bits/simd.h"
+#include "JNSTL/bits/topk.h"
 #include "JNSTL/iterator.h"
 
 namespace jnstl {
@@ -87,11 +95,61 @@ iter_swap(ForwardIt1 a, ForwardIt2 b) {
 }
 
 
+/* Elements whose value is their object representation, compared by their
+   bytes with the same result as operator ==. Floating point types are not,
+   +0.0 equals -0.0 and NaN nothing. */
+template <typename T>
+struct is_bitwise_comparable
+    : std::integral_constant<bool, std::is_integral<T>::value ||
+                                   std::is_enum<T>::value ||
+                                   std::is_pointer<T>::value> {};
+
+template <bool>
+struct fill_a {
+  template <typename ForwardIterator, typename T>
+  static void
+  fill(ForwardIterator first, ForwardIterator last, const T& value) {
+    for (; first != last; ++first)
+      *first = value;
+  }
+};
+
+template <>
+struct fill_a<true> {
+  template <typename Tp, typename T>
+  static void
+  fill(Tp* first, Tp* last, const T& value) {
+    if (first == last)
+      return;
+
+    const Tp tmp = value;
+
+    if (sizeof(Tp) == 1)
+      memset(first, *reinterpret_cast<const unsigned char*>(&tmp),
+             last - first);
+    else
+      jnstl::simd_fill_n(first, last - first, tmp);
+  }
+};
+
+/* Raw pointers to trivially copyable elements of 1, 2, 4, 8 or 16 bytes are
+   filled by storing the bytes of the value, given the same type or an
+   arithmetic conversion (an assignment operator taking T could do
+   anything). */
 template <typename ForwardIterator, typename T>
 inline void
 fill_impl(ForwardIterator first, ForwardIterator last, const T& value) {
-  for (; first != last; ++first)
-    *first = value;
+  typedef typename iterator_traits<ForwardIterator>::value_type ValueType;
+
+  const bool is_simple = (std::is_pointer<ForwardIterator>::value &&
+                          std::is_trivially_copyable<ValueType>::value &&
+                          !std::is_volatile<ValueType>::value &&
+                          16 % sizeof(ValueType) == 0 &&
+                          (std::is_same<ValueType, T>::value ||
+                           (std::is_arithmetic<ValueType>::value &&
+                            std::is_arithmetic<T>::value)));
+
+  jnstl::fill_a<is_simple>::fill(first, last, value);
 }
 
 /**
@@ -418,8 +476,7 @@ equal_impl(II1 first1, II1 last1, II2 first2) {
   typedef typename iterator_traits<II1>::value_type ValueType1;
   typedef typename iterator_traits<II2>::value_type ValueType2;
 
-  const bool is_simple = ((std::numeric_limits<ValueType1>::is_integer
-                           || std::is_pointer<ValueType1>::value)
+  const bool is_simple = (jnstl::is_bitwise_comparable<ValueType1>::value
                           && std::is_pointer<II1>::value
                           && std::is_pointer<II2>::value
                           && std::is_same<ValueType1, ValueType2>::value);
@@ -690,6 +747,218 @@ sort_heap(RandomIt first, RandomIt last) {
   jnstl::sort_heap(first, last, comp);
 }
 
+/**
+ * @brief Finds the largest range in range [first, last) that is a max heap
+ *        of Arity children per node.
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first An iterator.
+ * @param last  An iterator.
+ * @param comp  A function to compare elements.
+ * @return An iterator.
+ *
+ * The children of the element at index i are the Arity elements from index
+ * Arity * i + 1. is_heap_until<2> is the same as is_heap_until.
+ */
+template <size_t Arity, typename RandomIt, typename Compare>
+RandomIt
+is_heap_until(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  const difference_type heapSize(last - first);
+
+  for (difference_type childIdx = 1; childIdx < heapSize; ++childIdx) {
+    if (comp(*(first + (childIdx - 1) / difference_type(Arity)),
+             *(first + childIdx)))
+      return first + childIdx;
+  }
+  return first + heapSize;
+}
+
+/**
+ * @brief Finds the largest range in range [first, last) that is a max heap
+ *        of Arity children per node.
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first An iterator.
+ * @param last  An iterator.
+ * @return An iterator.
+ */
+template <size_t Arity, typename RandomIt>
+inline RandomIt
+is_heap_until(RandomIt first, RandomIt last) {
+  std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
+  return jnstl::is_heap_until<Arity>(first, last, comp);
+}
+
+/**
+ * @brief Checks if the element in range [first, last) are a max heap of
+ *        Arity children per node.
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first An iterator.
+ * @param last  An iterator.
+ * @param comp  A function to compare elements.
+ * @return A boolean, true or false.
+ */
+template <size_t Arity, typename RandomIt, typename Compare>
+inline bool
+is_heap(RandomIt first, RandomIt last, Compare comp) {
+  return (jnstl::is_heap_until<Arity>(first, last, comp) == last);
+}
+
+/**
+ * @brief Checks if the element in range [first, last) are a max heap of
+ *        Arity children per node.
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first An iterator.
+ * @param last  An iterator.
+ * @return A boolean, true or false.
+ */
+template <size_t Arity, typename RandomIt>
+inline bool
+is_heap(RandomIt first, RandomIt last) {
+  return (jnstl::is_heap_until<Arity>(first, last) == last);
+}
+
+/**
+ * @brief Pushes last elemnt onto the heap of Arity children per node.
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first Start of heap.
+ * @param last  End of heap.
+ * @param comp  A function to compare elements.
+ *
+ * A push compares one element per level, a heap of 4 or 8 children per node
+ * is 2 or 3 times shallower than a binary one.
+ */
+template <size_t Arity, typename RandomIt, typename Compare>
+inline void
+push_heap(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  value_type val = LIB::move(*(last -1));
+  jnstl::dary_heap<Arity>::promote(first, difference_type(last - first -1),
+                                   difference_type(0), LIB::move(val), comp);
+}
+
+/**
+ * @brief Pushes last elemnt onto the heap of Arity children per node.
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first Start of heap.
+ * @param last  End of heap.
+ */
+template <size_t Arity, typename RandomIt>
+inline void
+push_heap(RandomIt first, RandomIt last) {
+  std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
+  jnstl::push_heap<Arity>(first, last, comp);
+}
+
+/**
+ * @brief Constructs a max heap of Arity children per node in the range
+ *        [first, last).
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first Start of heap.
+ * @param last  End of heap.
+ * @param comp  A function to compare elements.
+ */
+template <size_t Arity, typename RandomIt, typename Compare>
+inline void
+make_heap(RandomIt first, RandomIt last, Compare comp) {
+  jnstl::dary_heap<Arity>::make(first, last, comp);
+}
+
+/**
+ * @brief Constructs a max heap of Arity children per node in the range
+ *        [first, last).
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first Start of heap.
+ * @param last  End of heap.
+ */
+template <size_t Arity, typename RandomIt>
+inline void
+make_heap(RandomIt first, RandomIt last) {
+  std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
+  jnstl::make_heap<Arity>(first, last, comp);
+}
+
+/**
+ * @brief Pop an elemnt off the top of the heap of Arity children per node.
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first Start of heap.
+ * @param last  End of heap.
+ * @param comp  A comparison function.
+ *
+ * The top moves to last - 1 as with pop_heap. Every level of the heap
+ * compares the Arity children of a node, which are next to each other in
+ * memory, the number of levels is log(n) / log(Arity): on heaps larger than
+ * the caches 4 or 8 children per node save most of the cache misses.
+ */
+template <size_t Arity, typename RandomIt, typename Compare>
+inline void
+pop_heap(RandomIt first, RandomIt last, Compare comp) {
+  if (first != last) {
+    --last;
+    jnstl::dary_heap<Arity>::pop(first, last, last, comp);
+  }
+}
+
+/**
+ * @brief Pop an elemnt off the top of the heap of Arity children per node.
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first Start of heap.
+ * @param last  End of heap.
+ */
+template <size_t Arity, typename RandomIt>
+inline void
+pop_heap(RandomIt first, RandomIt last) {
+  std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
+  jnstl::pop_heap<Arity>(first, last, comp);
+}
+
+/**
+ * @brief Convertes the max heap of Arity children per node into a sorted
+ *        range.
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first Start of heap.
+ * @param last  End of heap.
+ * @param comp  A comparison function.
+ */
+template <size_t Arity, typename RandomIt, typename Compare>
+inline void
+sort_heap(RandomIt first, RandomIt last, Compare comp) {
+  while (last - first > 1) {
+    --last;
+    jnstl::dary_heap<Arity>::pop(first, last, last, comp);
+  }
+}
+
+/**
+ * @brief Convertes the max heap of Arity children per node into a sorted
+ *        range.
+ * @ingroup heap_algorithms
+ * @tparam Arity The number of children of a node.
+ * @param first Start of heap.
+ * @param last  End of heap.
+ */
+template <size_t Arity, typename RandomIt>
+inline void
+sort_heap(RandomIt first, RandomIt last) {
+  std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
+  jnstl::sort_heap<Arity>(first, last, comp);
+}
+
 /**
  * @brief Tests two ranges for element-wise equality.
  * @ingroup non_modifying_algorithms
@@ -713,6 +982,92 @@ equal(InputIter1 first1, InputIter1 last1, InputIter2 first2,
   return true;
 }
 
+template <bool>
+struct mismatch_a {
+  template <typename II1, typename II2>
+  static jnstl::pair<II1, II2>
+  mismatch(II1 first1, II1 last1, II2 first2) {
+    while (first1 != last1 && *first1 == *first2) {
+      ++first1;
+      ++first2;
+    }
+    return jnstl::pair<II1, II2>(first1, first2);
+  }
+};
+
+template <>
+struct mismatch_a<true> {
+  template <typename Tp1, typename Tp2>
+  static jnstl::pair<Tp1*, Tp2*>
+  mismatch(Tp1* first1, Tp1* last1, Tp2* first2) {
+    const size_t n = jnstl::simd_mismatch_n<Tp1>(first1, first2,
+                                                 last1 - first1);
+
+    return jnstl::pair<Tp1*, Tp2*>(first1 + n, first2 + n);
+  }
+};
+
+template <typename II1, typename II2>
+inline jnstl::pair<II1, II2>
+mismatch_impl(II1 first1, II1 last1, II2 first2) {
+  typedef typename iterator_traits<II1>::value_type ValueType1;
+  typedef typename iterator_traits<II2>::value_type ValueType2;
+
+  const bool is_simple = (jnstl::is_bitwise_comparable<ValueType1>::value
+                          && std::is_pointer<II1>::value
+                          && std::is_pointer<II2>::value
+                          && std::is_same<ValueType1, ValueType2>::value);
+
+  return jnstl::mismatch_a<is_simple>::mismatch(first1, last1, first2);
+}
+
+/**
+ * @brief Finds the first position where two ranges differ.
+ * @ingroup non_modifying_algorithms
+ * @param first1 An input iterator.
+ * @param last1  An input iterator.
+ * @param first2 An input iterator.
+ * @return A pair of iterators to the first elements that are not equal, the
+ *         first one being last1 if there are none.
+ *
+ * This function compares the elements of the two ranges using @c ==.
+ * Contiguous ranges of integers, enums or pointers are compared by blocks of
+ * 16 or 32 bytes, with the widest vector instructions the processor has.
+ */
+template <typename InputIterator1, typename InputIterator2>
+inline jnstl::pair<InputIterator1, InputIterator2>
+mismatch(InputIterator1 first1, InputIterator1 last1,
+         InputIterator2 first2) {
+  const auto res = jnstl::mismatch_impl(jnstl::niter_base(first1),
+                                        jnstl::niter_base(last1),
+                                        jnstl::niter_base(first2));
+
+  return jnstl::pair<InputIterator1, InputIterator2>(
+      jnstl::niter_wrap(first1, res.first),
+      jnstl::niter_wrap(first2, res.second));
+}
+
+/**
+ * @brief Finds the first position where two ranges differ.
+ * @ingroup non_modifying_algorithms
+ * @param first1 An input iterator.
+ * @param last1  An input iterator.
+ * @param first2 An input iterator.
+ * @param p      A binary predicate.
+ * @return A pair of iterators to the first elements for which @p p does not
+ *         hold, the first one being last1 if there are none.
+ */
+template <typename InputIter1, typename InputIter2, typename BinaryPredicate>
+inline jnstl::pair<InputIter1, InputIter2>
+mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+         BinaryPredicate p) {
+  while (first1 != last1 && static_cast<bool>(p(*first1, *first2))) {
+    ++first1;
+    ++first2;
+  }
+  return jnstl::pair<InputIter1, InputIter2>(first1, first2);
+}
+
 
 
 /**
@@ -783,69 +1138,162 @@ merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
       std::less<typename iterator_traits<InputIt1>::value_type>());
 }
 
-#if 0
 /**
- * @brief Merges two consecutive sorted ranges.
+ * @brief Merges the elements of several sorted ranges.
  * @ingroup sorting_algorithms
- * @params first  An iterator.
- * @params middle An iterator.
- * @params last   An iterator.
- * @return Nothing.
+ * @params seqFirst An input iterator to the ranges.
+ * @params seqLast  An input iterator to the ranges.
+ * @params d_first  An output iterator pointing to the beginning of the
+ *                  destination range.
+ * @params comp     A functor to use for comparison.
+ * @return An iterator to the element past the last merged element.
  *
- * This function merges two consecutive sorted ranges @p [first, middle) and
- * @p [middle, last) into one sorted range starting @p [first, last).
- * The elements are compared using operator <. The merge is stable, for
- * equivalent elements in the two original ranges,
- * the elements from the first range (preserving their original order) precede
- * the elements form the second range (preserving their original order).
- * Both input ranges must be sorted using the same operator <.
+ * This function merges the sorted ranges @p [seqFirst, seqLast), given as
+ * pairs of input iterators, into the sorted range starting at @p d_first.
+ * The elements are compared using the function @p comp. The heads of the
+ * k ranges compete in a loser tree, costing log2(k) comparisons per
+ * element, and each element is copied once, where chained two-way merges
+ * would copy it log2(k) times.
+ * The order of equivalent elements from different ranges is unspecified,
+ * see @p stable_multiway_merge().
+ * The output range must not overlap with any of the input ranges.
  */
-template <typename BidirIt>
-inline
-inplace_merge(BidirIt first, BidirIt middle, BidirIt last) {
-  jnstl::inplace_merge(first, middle, last,
-               std::less<typename iterator_traits<InputIt>::value_type>());
+template <typename SeqIt, typename OutputIt, typename Compare>
+inline OutputIt
+multiway_merge(SeqIt seqFirst, SeqIt seqLast, OutputIt d_first,
+               Compare comp) {
+  jnstl::multiway_ranges<SeqIt> ranges(seqFirst, seqLast);
+
+  return jnstl::multiway_merge_impl<false>(ranges.data(), ranges.size(),
+                                          d_first, comp);
+}
+
+/**
+ * @brief Merges the elements of several sorted ranges.
+ * @ingroup sorting_algorithms
+ * @params seqFirst An input iterator to the ranges.
+ * @params seqLast  An input iterator to the ranges.
+ * @params d_first  An output iterator pointing to the beginning of the
+ *                  destination range.
+ * @return An iterator to the element past the last merged element.
+ *
+ * Same as the comparison function overload, comparing the elements using
+ * operator <.
+ */
+template <typename SeqIt, typename OutputIt>
+inline OutputIt
+multiway_merge(SeqIt seqFirst, SeqIt seqLast, OutputIt d_first) {
+  typedef typename jnstl::multiway_source<SeqIt>::iterator iterator;
+
+  return jnstl::multiway_merge(
+      seqFirst, seqLast, d_first,
+      std::less<typename iterator_traits<iterator>::value_type>());
+}
+
+/**
+ * @brief Merges the elements of several sorted ranges, preserving the
+ * order of equivalent elements.
+ * @ingroup sorting_algorithms
+ * @params seqFirst An input iterator to the ranges.
+ * @params seqLast  An input iterator to the ranges.
+ * @params d_first  An output iterator pointing to the beginning of the
+ *                  destination range.
+ * @params comp     A functor to use for comparison.
+ * @return An iterator to the element past the last merged element.
+ *
+ * Same as @p multiway_merge(), equivalent elements are output in the order
+ * of their ranges, and of their positions within a range.
+ */
+template <typename SeqIt, typename OutputIt, typename Compare>
+inline OutputIt
+stable_multiway_merge(SeqIt seqFirst, SeqIt seqLast, OutputIt d_first,
+                      Compare comp) {
+  jnstl::multiway_ranges<SeqIt> ranges(seqFirst, seqLast);
+
+  return jnstl::multiway_merge_impl<true>(ranges.data(), ranges.size(),
+                                          d_first, comp);
+}
+
+/**
+ * @brief Merges the elements of several sorted ranges, preserving the
+ * order of equivalent elements.
+ * @ingroup sorting_algorithms
+ * @params seqFirst An input iterator to the ranges.
+ * @params seqLast  An input iterator to the ranges.
+ * @params d_first  An output iterator pointing to the beginning of the
+ *                  destination range.
+ * @return An iterator to the element past the last merged element.
+ *
+ * Same as the comparison function overload, comparing the elements using
+ * operator <.
+ */
+template <typename SeqIt, typename OutputIt>
+inline OutputIt
+stable_multiway_merge(SeqIt seqFirst, SeqIt seqLast, OutputIt d_first) {
+  typedef typename jnstl::multiway_source<SeqIt>::iterator iterator;
+
+  return jnstl::stable_multiway_merge(
+      seqFirst, seqLast, d_first,
+      std::less<typename iterator_traits<iterator>::value_type>());
 }
 
 /**
  * @brief Merges two consecutive sorted ranges.
  * @ingroup sorting_algorithms
- * @params first  An iterator.
- * @params middle An iterator.
- * @params last   An iterator.
- * @params comp  A functor to use for comparison.
+ * @params first  A bidirectional iterator.
+ * @params middle A bidirectional iterator.
+ * @params last   A bidirectional iterator.
+ * @params comp   A functor to use for comparison.
  * @return Nothing.
  *
  * This function merges two consecutive sorted ranges @p [first, middle) and
- * @p [middle, last) into one sorted range starting @p [first, last).
+ * @p [middle, last) into one sorted range @p [first, last).
  * The elements are compared using the function @p comp. The merge is stable,
  * for equivalent elements in the two original ranges,
  * the elements from the first range (preserving their original order) precede
- * the elements form the second range (preserving their original order).
+ * the elements from the second range (preserving their original order).
  * Both input ranges must be sorted using the same function @p comp.
+ *
+ * The shorter range is moved to a temporary buffer and merged back, in
+ * linear time. When the buffer cannot be had the ranges are merged in place
+ * by rotations, in O(n log n) time.
  */
-template <typename BidirIt>
-inline
+template <typename BidirIt, typename Compare>
+inline void
 inplace_merge(BidirIt first, BidirIt middle, BidirIt last, Compare comp) {
-  typedef typename iterator_traits<RandomIt>::value_type        value_type;
-  typedef typename iterator_traits<RandomIt>::differrence_type  size_type;
+  typedef typename iterator_traits<BidirIt>::iterator_category category;
 
   if (first == middle || middle == last)
     return;
 
-  const size_type count = last - first;
-  const size_type len1 = middle - first;
-  const size_type len2 = last - middle;
-
-  value_type* const buffer = static_cast<value_type*>(
-      jnstl::allocator::allocate(count * sizeof(value_type)));
-
-  jnstl::merge_with_buffer(first, middle, last, len1, len2,
-                           buffer, count, comp);
+  jnstl::inplace_merge_impl<
+      std::is_base_of<jnstl::random_access_iterator_tag, category>::value ||
+      std::is_base_of<std::random_access_iterator_tag, category>::value>::
+      merge(first, middle, last, comp);
+}
 
-  jnstl::allocator::deallocate(buffer, count * sizeof(value_type));
+/**
+ * @brief Merges two consecutive sorted ranges.
+ * @ingroup sorting_algorithms
+ * @params first  A bidirectional iterator.
+ * @params middle A bidirectional iterator.
+ * @params last   A bidirectional iterator.
+ * @return Nothing.
+ *
+ * This function merges two consecutive sorted ranges @p [first, middle) and
+ * @p [middle, last) into one sorted range @p [first, last).
+ * The elements are compared using operator <. The merge is stable, for
+ * equivalent elements in the two original ranges,
+ * the elements from the first range (preserving their original order) precede
+ * the elements from the second range (preserving their original order).
+ * Both input ranges must be sorted using the same operator <.
+ */
+template <typename BidirIt>
+inline void
+inplace_merge(BidirIt first, BidirIt middle, BidirIt last) {
+  jnstl::inplace_merge(first, middle, last,
+      std::less<typename iterator_traits<BidirIt>::value_type>());
 }
-#endif
 
 /**
  * @brief Finds the largest range in range [first, last) that is sorted.
@@ -942,10 +1390,25 @@ stable_sort(RandomIt first, RandomIt last, Compare comp) {
 
   const difference_type count = last - first;
 
-  typedef temporary_buffer<RandomIt, value_type> tmp_buf;
-  tmp_buf buffer(first, last);
+  if (count <= jnstl::merge_min_run) {
+    jnstl::insertion_sort(first, last, comp);
+    return;
+  }
+
+  /* Merges move the shorter run out, half the range is all they need. A
+     smaller (or no) buffer only makes the longer merges slower. */
+  jnstl::pair<value_type*, ptrdiff_t> buffer =
+      jnstl::get_temporary_buffer<value_type>((count + 1) / 2);
 
-  jnstl::merge_sort_buffer(first, last, buffer.begin(), comp);
+  if (buffer.first != nullptr)
+    jnstl::uninitialized_construct_buf(buffer.first,
+                                       buffer.first + buffer.second, first);
+
+  jnstl::merge_sort_adaptive(first, last, buffer.first,
+                             difference_type(buffer.second), comp);
+
+  jnstl::Destruct(buffer.first, buffer.first + buffer.second);
+  jnstl::return_temporary_buffer(buffer.first);
 }
 
 /**
@@ -982,10 +1445,7 @@ stable_sort(RandomIt first, RandomIt last) {
 template <typename RandomIt, typename Compare>
 inline void
 sort(RandomIt first, RandomIt last, Compare comp) {
-  if (first != last) {
-    jnstl::introsort_loop(first, last, std::log(last - first) * 2, comp);
-    jnstl::final_insertion_sort(first, last, comp);
-  }
+  jnstl::pdqsort(first, last, comp);
 }
 
 /**
@@ -1021,11 +1481,15 @@ sort(RandomIt first, RandomIt last) {
  * such that they occupy the range [first, middle).
  * The order of equal elements is not guaranteed to be preserved and the order
  * of the elements in the range [middle, last) is unspecified.
+ * A few elements are kept sorted by insertion, more in a heap, and a large
+ * share of the range is selected with nth_element then sorted. Arithmetic
+ * elements compared by std::less or std::greater are screened by blocks
+ * against the largest element kept.
  */
 template <typename RandomIt, typename Compare>
 inline void
 partial_sort(RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
-  jnstl::partial_sort_impl(first, middle, last, comp);
+  jnstl::topk_partial_sort(first, middle, last, comp);
 }
 
 /**
@@ -1046,9 +1510,188 @@ template <typename RandomIt>
 inline void
 partial_sort(RandomIt first, RandomIt middle, RandomIt last) {
   std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
-  jnstl::partial_sort_impl(first, middle, last, comp);
+  jnstl::topk_partial_sort(first, middle, last, comp);
+}
+
+/**
+ * @brief Copies and sorts the smallest elements of a sequence.
+ * @ingroup sorting_algorithms
+ * @params first   An input iterator.
+ * @params last    An input iterator.
+ * @params d_first A random access iterator.
+ * @params d_last  A random access iterator.
+ * @params comp    A function to compare elements.
+ * @return An iterator to the element past the last copied element.
+ *
+ * This function copies the smallest min(last - first, d_last - d_first)
+ * elements of the range @p [first, last) to @p [d_first, d_last), sorted
+ * using the function @p comp. The input range is read only once.
+ * The order of equal elements is not guaranteed to be preserved.
+ */
+template <typename InputIt, typename RandomIt, typename Compare>
+inline RandomIt
+partial_sort_copy(InputIt first, InputIt last, RandomIt d_first,
+                  RandomIt d_last, Compare comp) {
+  return jnstl::topk_partial_sort_copy(first, last, d_first, d_last, comp);
+}
+
+/**
+ * @brief Copies and sorts the smallest elements of a sequence.
+ * @ingroup sorting_algorithms
+ * @params first   An input iterator.
+ * @params last    An input iterator.
+ * @params d_first A random access iterator.
+ * @params d_last  A random access iterator.
+ * @return An iterator to the element past the last copied element.
+ *
+ * This function copies the smallest min(last - first, d_last - d_first)
+ * elements of the range @p [first, last) to @p [d_first, d_last), sorted
+ * using the operator <.
+ * The order of equal elements is not guaranteed to be preserved.
+ */
+template <typename InputIt, typename RandomIt>
+inline RandomIt
+partial_sort_copy(InputIt first, InputIt last, RandomIt d_first,
+                  RandomIt d_last) {
+  std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
+  return jnstl::topk_partial_sort_copy(first, last, d_first, d_last, comp);
+}
+
+/**
+ * @brief Partially sorts the range [first, last) around nth.
+ * @ingroup sorting_algorithms
+ * @params first A random access iterator.
+ * @params nth   A random access iterator.
+ * @params last  A random access iterator.
+ * @params comp  A function to compare elements.
+ * @return Nothing.
+ *
+ * This function rearranges the elements in the range @p [first, last) so
+ * that @p nth holds the element that would be there if the range was sorted
+ * using the function @p comp, no element of @p [first, nth) is greater than
+ * it and no element of @p [nth + 1, last) is less than it.
+ * Runs a quickselect on a median of three pivot, switching to the median of
+ * medians after too many partitions, in guaranteed O(n) time.
+ */
+template <typename RandomIt, typename Compare>
+inline void
+nth_element(RandomIt first, RandomIt nth, RandomIt last, Compare comp) {
+  if (first == last || nth == last)
+    return;
+
+  jnstl::introselect(first, nth, last, 2 * jnstl::sort_log2(last - first),
+                     comp);
+}
+
+/**
+ * @brief Partially sorts the range [first, last) around nth.
+ * @ingroup sorting_algorithms
+ * @params first A random access iterator.
+ * @params nth   A random access iterator.
+ * @params last  A random access iterator.
+ * @return Nothing.
+ *
+ * This function rearranges the elements in the range @p [first, last) so
+ * that @p nth holds the element that would be there if the range was sorted
+ * using the operator <, see the comparison function overload for details.
+ */
+template <typename RandomIt>
+inline void
+nth_element(RandomIt first, RandomIt nth, RandomIt last) {
+  std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
+  jnstl::nth_element(first, nth, last, comp);
+}
+
+/**
+ * @brief Partially sorts the range [first, last) around several positions.
+ * @ingroup sorting_algorithms
+ * @params first    A random access iterator.
+ * @params last     A random access iterator.
+ * @params nthFirst A random access iterator to the positions.
+ * @params nthLast  A random access iterator to the positions.
+ * @params comp     A function to compare elements.
+ * @return Nothing.
+ *
+ * This function does what nth_element would do for every iterator of
+ * @p [nthFirst, nthLast), which must be positions of @p [first, last) in
+ * ascending order: each one holds the element that would be there if the
+ * range was sorted using the function @p comp, and the elements between
+ * two consecutive positions are neither less than the first one nor greater
+ * than the second one. It takes O(n log k) time for k positions, computing
+ * several percentiles of a sample at once for instance.
+ */
+template <typename RandomIt, typename NthIt, typename Compare>
+inline void
+nth_elements(RandomIt first, RandomIt last, NthIt nthFirst, NthIt nthLast,
+             Compare comp) {
+  if (last - first < 2)
+    return;
+
+  jnstl::multiselect_loop(first, last, nthFirst, nthLast,
+                          2 * jnstl::sort_log2(last - first), comp);
+}
+
+/**
+ * @brief Partially sorts the range [first, last) around several positions.
+ * @ingroup sorting_algorithms
+ * @params first    A random access iterator.
+ * @params last     A random access iterator.
+ * @params nthFirst A random access iterator to the positions.
+ * @params nthLast  A random access iterator to the positions.
+ * @return Nothing.
+ *
+ * This function does what nth_element would do for every iterator of
+ * @p [nthFirst, nthLast), comparing the elements using the operator <, see
+ * the comparison function overload for details.
+ */
+template <typename RandomIt, typename NthIt>
+inline void
+nth_elements(RandomIt first, RandomIt last, NthIt nthFirst, NthIt nthLast) {
+  std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
+  jnstl::nth_elements(first, last, nthFirst, nthLast, comp);
+}
+
+/**
+ * @brief Sorts the elements in the range [first, last) by their radix.
+ * @ingroup sorting_algorithms
+ * @params first A random access iterator.
+ * @params last  A random access iterator.
+ * @params keyOf A functor returning the integral or floating point key of
+ *               an element.
+ * @return Nothing.
+ *
+ * This function sorts the elements in the range @p [first, last) in
+ * ascending order of their keys without comparing them, in O(n * w) for
+ * w-byte keys. Signed keys and IEEE floating point keys are supported,
+ * negative zero sorts before positive zero and NaNs are ordered by their
+ * bit pattern.
+ * An LSD sort is used when the keys differ on few bytes compared to the
+ * size of the range and a scratch buffer of the size of the range is
+ * available, an in-place MSD sort otherwise.
+ * The order of equal elements is not guaranteed to be preserved.
+ */
+template <typename RandomIt, typename KeyOf>
+inline void
+radix_sort(RandomIt first, RandomIt last, KeyOf keyOf) {
+  jnstl::radix_sort_impl(first, last, keyOf);
 }
 
+/**
+ * @brief Sorts the elements in the range [first, last) by their radix.
+ * @ingroup sorting_algorithms
+ * @params first A random access iterator.
+ * @params last  A random access iterator.
+ * @return Nothing.
+ *
+ * This function sorts the integral or floating point elements in the range
+ * @p [first, last) in ascending order without comparing them, see the
+ * key extractor overload for details.
+ */
+template <typename RandomIt>
+inline void
+radix_sort(RandomIt first, RandomIt last) {
+  jnstl::radix_sort_impl(first, last, jnstl::radix_identity());
+}
 
 }  // namespace jnstl
 
@@ -2,6 +2,7 @@
 #define JNSTL_ALLOCATOR_H_
 
 #include <cstdlib>
+#include <type_traits>
 
 #include "JNSTL/bits/config.h"
 
@@ -18,6 +19,75 @@ class allocator {
 bool operator==(const allocator& lhs, const allocator& rhs);
 bool operator!=(const allocator& lhs, const allocator& rhs);
 
+/* Allocators handing out malloc'ed blocks, which can be resized in place
+   with realloc(). */
+template <typename Allocator>
+struct is_realloc_allocator
+    : public std::false_type {};
+
+template <>
+struct is_realloc_allocator<allocator>
+    : public std::true_type {};
+
+/**
+ * @brief Allocator adaptor over-aligning every allocation.
+ *
+ * @tparam Alignment A power of two, e.g. 64 for a cache line or 32 for AVX.
+ * @tparam Allocator The allocator the requests are forwarded to.
+ *
+ * Every block is aligned to @p Alignment and its size is rounded up to a
+ * multiple of @p Alignment, so a vector<float, aligned_allocator<64>> buffer
+ * can feed aligned SIMD loads and shares no cache line with other
+ * allocations.
+ */
+template <size_t Alignment, typename Allocator = jnstl::allocator>
+class aligned_allocator {
+  static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0,
+                "Alignment must be a power of two");
+
+ public:
+  typedef Allocator allocator_type;
+
+  aligned_allocator()
+      : mAllocator() {}
+
+  explicit
+  aligned_allocator(const allocator_type& allocator)
+      : mAllocator(allocator) {}
+
+  void* allocate(size_t n) {
+    return mAllocator.allocate(sRoundUp(n), Alignment, 0);
+  }
+
+  void* allocate(size_t n, size_t alignment, size_t offset) {
+    return mAllocator.allocate(sRoundUp(n),
+                               alignment > Alignment ? alignment : Alignment,
+                               offset);
+  }
+
+  void deallocate(void* p, size_t n) {
+    mAllocator.deallocate(p, sRoundUp(n));
+  }
+
+  const allocator_type& get_allocator() const {
+    return mAllocator;
+  }
+
+ private:
+  allocator_type mAllocator;
+
+  static size_t sRoundUp(size_t n) {
+    return (n + Alignment - 1) & ~(Alignment - 1);
+  }
+};
+
+template <size_t Alignment, typename Allocator>
+bool operator==(const aligned_allocator<Alignment, Allocator>& lhs,
+                const aligned_allocator<Alignment, Allocator>& rhs);
+template <size_t Alignment, typename Allocator>
+bool operator!=(const aligned_allocator<Alignment, Allocator>& lhs,
+                const aligned_allocator<Alignment, Allocator>& rhs);
+
 inline void* allocator::allocate(size_t n) {
   if (n > 0)
     return ::malloc(n);
@@ -25,6 +95,28 @@ inline void* allocator::allocate(size_t n) {
     return nullptr;
 }
 
+/* Returns a block of n bytes such that (p + offset) is a multiple of
+   alignment. Blocks are released with deallocate like any other, so they
+   have to come straight from the system allocator: this restricts offset to
+   multiples of alignment, nullptr is returned otherwise. An alignment of 0
+   stands for the one of malloc, others have to be powers of two. */
+inline void* allocator::allocate(size_t n, size_t alignment, size_t offset) {
+  if (alignment == 0)
+    alignment = JNSTL_MALLOC_ALIGNMENT;
+
+  if (n == 0 || (alignment & (alignment - 1)) != 0 ||
+      (offset % alignment) != 0)
+    return nullptr;
+
+  if (alignment <= JNSTL_MALLOC_ALIGNMENT)
+    return ::malloc(n);
+
+  void* p = nullptr;
+  if (::posix_memalign(&p, alignment, n) != 0)
+    return nullptr;
+  return p;
+}
+
 inline void allocator::deallocate(void* p, size_t) {
   free(p);
 }
@@ -37,6 +129,18 @@ inline bool operator!=(const allocator&, const allocator&) {
   return false;
 }
 
+template <size_t Alignment, typename Allocator>
+inline bool operator==(const aligned_allocator<Alignment, Allocator>& lhs,
+                       const aligned_allocator<Alignment, Allocator>& rhs) {
+  return lhs.get_allocator() == rhs.get_allocator();
+}
+
+template <size_t Alignment, typename Allocator>
+inline bool operator!=(const aligned_allocator<Alignment, Allocator>& lhs,
+                       const aligned_allocator<Alignment, Allocator>& rhs) {
+  return !(lhs == rhs);
+}
+
 }  // namespace jnstl
 
 #endif /* JNSTL_ALLOCATOR_H_ */
@@ -0,0 +1,242 @@
+#ifndef JNSTL_ARENA_ALLOCATOR_H_
+#define JNSTL_ARENA_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "JNSTL/bits/config.h"
+#include "JNSTL/allocator.h"
+
+namespace jnstl {
+/**
+ * @brief A monotonic memory resource made of chained blocks.
+ *
+ * Memory is carved linearly out of the current block; when a request does not
+ * fit a new block is malloc'ed and chained in front of the previous ones.
+ * deallocate() is a no-op, all the memory is given back at once by release()
+ * or by the destructor, in O(number of blocks).
+ * The arena is not copyable, containers refer to it through arena_allocator.
+ */
+class monotonic_arena {
+ public:
+  static const size_t kDefaultBlockSize = 64 * 1024;
+  static const size_t kMaxBlockSize     = 16 * 1024 * 1024;
+  static const size_t kDefaultAlignment = alignof(std::max_align_t);
+
+  explicit monotonic_arena(size_t blockSize = kDefaultBlockSize);
+  ~monotonic_arena();
+
+  void* allocate(size_t n);
+  void* allocate(size_t n, size_t alignment, size_t offset);
+
+  void deallocate(void* p, size_t n);
+
+  /* Frees every block. Containers still referring to the arena must be
+     cleared or destroyed before. */
+  void release();
+
+  size_t block_count() const;
+  size_t bytes_reserved() const;
+
+ private:
+  struct Block {
+    Block* mNext;
+    size_t mSize;
+  };
+
+  Block* mHead;
+  char*  mCurrent;
+  char*  mEnd;
+  size_t mBlockSize;
+  size_t mBlockCount;
+  size_t mReserved;
+
+  void* DoAllocateBlock(size_t n, size_t alignment, size_t offset);
+
+  monotonic_arena(const monotonic_arena&);
+  void operator=(const monotonic_arena&);
+};
+
+/**
+ * @brief Allocator handle forwarding to a monotonic_arena.
+ *
+ * Has the same interface as jnstl::allocator so it can be used as the
+ * Allocator parameter of vector, list and the rbtree based containers.
+ * Copies share the arena and compare equal. A default constructed
+ * arena_allocator has no arena and falls back to jnstl::allocator.
+ */
+class arena_allocator {
+ public:
+  arena_allocator();
+  arena_allocator(monotonic_arena* arena);
+
+  void* allocate(size_t n);
+  void* allocate(size_t n, size_t alignment, size_t offset);
+
+  void deallocate(void* p, size_t n);
+
+  monotonic_arena* get_arena() const;
+
+ private:
+  monotonic_arena* mArena;
+};
+
+bool operator==(const arena_allocator& lhs, const arena_allocator& rhs);
+bool operator!=(const arena_allocator& lhs, const arena_allocator& rhs);
+
+// monotonic_arena //
+
+inline monotonic_arena::monotonic_arena(size_t blockSize)
+    : mHead(nullptr),
+      mCurrent(nullptr),
+      mEnd(nullptr),
+      mBlockSize(blockSize > sizeof(Block) ? blockSize : kDefaultBlockSize),
+      mBlockCount(0),
+      mReserved(0) {}
+
+inline monotonic_arena::~monotonic_arena() {
+  release();
+}
+
+inline void* monotonic_arena::allocate(size_t n) {
+  return allocate(n, kDefaultAlignment, 0);
+}
+
+inline void* monotonic_arena::allocate(size_t n, size_t alignment,
+                                       size_t offset) {
+  /* Same alignment contract as jnstl::allocator: 0 means the default
+     alignment and anything else must be a power of two. */
+  if (alignment == 0)
+    alignment = kDefaultAlignment;
+
+  if (n == 0 || (alignment & (alignment - 1)) != 0)
+    return nullptr;
+
+  if (mCurrent != nullptr) {
+    /* Align (p + offset), as jnstl::allocator does */
+    const uintptr_t mask = static_cast<uintptr_t>(alignment - 1);
+    const uintptr_t pos  = reinterpret_cast<uintptr_t>(mCurrent) + offset;
+    const size_t    pad  = static_cast<size_t>(((pos + mask) & ~mask) - pos);
+
+    if (pad <= static_cast<size_t>(mEnd - mCurrent) &&
+        n <= static_cast<size_t>(mEnd - mCurrent) - pad) {
+      char* const p = mCurrent + pad;
+      mCurrent = p + n;
+      return p;
+    }
+  }
+
+  return DoAllocateBlock(n, alignment, offset);
+}
+
+inline void monotonic_arena::deallocate(void*, size_t) {
+  // Monotonic, memory is only given back by release().
+}
+
+inline void monotonic_arena::release() {
+  while (mHead != nullptr) {
+    Block* const pNext = mHead->mNext;
+    ::free(mHead);
+    mHead = pNext;
+  }
+  mCurrent    = nullptr;
+  mEnd        = nullptr;
+  mBlockCount = 0;
+  mReserved   = 0;
+}
+
+inline size_t monotonic_arena::block_count() const {
+  return mBlockCount;
+}
+
+inline size_t monotonic_arena::bytes_reserved() const {
+  return mReserved;
+}
+
+inline void* monotonic_arena::DoAllocateBlock(size_t n, size_t alignment,
+                                              size_t offset) {
+  /* Worst case padding needed to align the first allocation of the block,
+     requests whose size does not even fit a size_t fail like malloc. */
+  if (alignment > SIZE_MAX - sizeof(Block) ||
+      offset > SIZE_MAX - sizeof(Block) - alignment ||
+      n > SIZE_MAX - sizeof(Block) - alignment - offset)
+    return nullptr;
+
+  const size_t needed = sizeof(Block) + alignment + offset + n;
+  size_t size = mBlockSize;
+
+  while (size < needed) {
+    if (size > SIZE_MAX / 2) {
+      size = needed;
+      break;
+    }
+    size *= 2;
+  }
+
+  Block* const pBlock = static_cast<Block*>(::malloc(size));
+  if (pBlock == nullptr)
+    return nullptr;
+
+  pBlock->mNext = mHead;
+  pBlock->mSize = size;
+  mHead = pBlock;
+  ++mBlockCount;
+  mReserved += size;
+
+  /* Grow geometrically so that the number of blocks stays logarithmic in
+     the total size requested. */
+  if (mBlockSize < kMaxBlockSize)
+    mBlockSize *= 2;
+
+  mCurrent = reinterpret_cast<char*>(pBlock) + sizeof(Block);
+  mEnd     = reinterpret_cast<char*>(pBlock) + size;
+
+  return allocate(n, alignment, offset);
+}
+
+// arena_allocator //
+
+inline arena_allocator::arena_allocator()
+    : mArena(nullptr) {}
+
+inline arena_allocator::arena_allocator(monotonic_arena* arena)
+    : mArena(arena) {}
+
+inline void* arena_allocator::allocate(size_t n) {
+  if (mArena != nullptr)
+    return mArena->allocate(n);
+  return jnstl::allocator().allocate(n);
+}
+
+inline void* arena_allocator::allocate(size_t n, size_t alignment,
+                                       size_t offset) {
+  if (mArena != nullptr)
+    return mArena->allocate(n, alignment, offset);
+  return jnstl::allocator().allocate(n, alignment, offset);
+}
+
+inline void arena_allocator::deallocate(void* p, size_t n) {
+  if (mArena != nullptr)
+    mArena->deallocate(p, n);
+  else
+    jnstl::allocator().deallocate(p, n);
+}
+
+inline monotonic_arena* arena_allocator::get_arena() const {
+  return mArena;
+}
+
+inline bool operator==(const arena_allocator& lhs,
+                       const arena_allocator& rhs) {
+  return lhs.get_arena() == rhs.get_arena();
+}
+
+inline bool operator!=(const arena_allocator& lhs,
+                       const arena_allocator& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace jnstl
+
+#endif /* JNSTL_ARENA_ALLOCATOR_H_ */
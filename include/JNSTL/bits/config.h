@@ -2,8 +2,17 @@
 #define JNSTL_CONFIG_H_
 
 #include <cstdio>
+#include <cstddef>
 
 #define LIB std
 #define JNSTL_EXCEPTIONS_ENABLED 0
 #define JNSTL_OPTIMIZE_COPY 1
+#define JNSTL_MALLOC_ALIGNMENT alignof(std::max_align_t)
+#define JNSTL_CACHE_LINE_SIZE 64
+
+#if defined(__GNUC__) || defined(__clang__)
+#define JNSTL_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define JNSTL_PREFETCH(addr) ((void)(addr))
+#endif
 #endif /* JNSTL_CONFIG_H_ */
@@ -2,21 +2,17 @@
 #define JNSTL_CONSTRUCT_H_
 
 
+#include <utility>
+
 #include "./config.h"
 #include "JNSTL/iterator.h"
 
 namespace jnstl {
 
-template<typename T1, typename T2>
-inline void
-Construct(T1* p, const T2&& value) {
-  ::new(static_cast<void*>(p)) T1(LIB::move(value));
-}
-
-template<typename T1, typename T2>
+template<typename T, typename... Args>
 inline void
-Construct(T1* p, const T2& value) {
-  ::new(static_cast<void*>(p)) T1(value);
+Construct(T* p, Args&&... args) {
+  ::new(static_cast<void*>(p)) T(LIB::forward<Args>(args)...);
 }
 
 template <typename T>
@@ -0,0 +1,191 @@
+#ifndef JNSTL_EXECUTOR_H_
+#define JNSTL_EXECUTOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "JNSTL/bits/config.h"
+
+namespace jnstl {
+/**
+ * @brief A fork-join thread pool with work stealing, used by the parallel
+ * algorithms.
+ *
+ * Every thread owns a task deque. Tasks spawned by a thread go to the back
+ * of its own deque and are run from the back (LIFO, the most recently split
+ * and cache-hot range first), idle threads steal from the front of the other
+ * deques (FIFO, the oldest and largest ranges). The thread constructing the
+ * executor takes part in the work while it is in wait(), so an executor of
+ * n threads starts n - 1 workers.
+ * Tasks must not wait for each other, wait() is only meant to be called by
+ * the thread owning the executor. The executor is not copyable.
+ */
+class parallel_executor {
+ public:
+  typedef std::function<void()> task_type;
+
+  explicit parallel_executor(unsigned threads = 0);
+  ~parallel_executor();
+
+  unsigned concurrency() const;
+
+  void spawn(task_type task);
+
+  /* Runs tasks until every spawned task has completed. */
+  void wait();
+
+ private:
+  struct Worker {
+    std::mutex            mMutex;
+    std::deque<task_type> mTasks;
+  };
+
+  std::vector<std::unique_ptr<Worker>> mWorkers;
+  std::vector<std::thread>             mThreads;
+  std::atomic<size_t>                  mPending;
+  std::atomic<size_t>                  mQueued;
+  std::mutex                           mSleepMutex;
+  std::condition_variable              mWake;
+  bool                                 mStop;
+
+  static const parallel_executor*& sCurrentExecutor();
+  static size_t& sCurrentIndex();
+
+  size_t DoSelf() const;
+  bool   DoRunOne(size_t self);
+  void   DoWorkerLoop(size_t self);
+
+  parallel_executor(const parallel_executor&);
+  void operator=(const parallel_executor&);
+};
+
+inline parallel_executor::parallel_executor(unsigned threads)
+    : mPending(0),
+      mQueued(0),
+      mStop(false) {
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads == 0)
+    threads = 1;
+
+  for (unsigned i = 0; i < threads; ++i)
+    mWorkers.push_back(std::unique_ptr<Worker>(new Worker));
+
+  for (unsigned i = 1; i < threads; ++i)
+    mThreads.push_back(std::thread(&parallel_executor::DoWorkerLoop, this,
+                                   size_t(i)));
+}
+
+inline parallel_executor::~parallel_executor() {
+  {
+    std::lock_guard<std::mutex> lock(mSleepMutex);
+    mStop = true;
+  }
+  mWake.notify_all();
+
+  for (size_t i = 0; i < mThreads.size(); ++i)
+    mThreads[i].join();
+}
+
+inline unsigned parallel_executor::concurrency() const {
+  return static_cast<unsigned>(mWorkers.size());
+}
+
+inline const parallel_executor*& parallel_executor::sCurrentExecutor() {
+  static thread_local const parallel_executor* sExecutor = nullptr;
+  return sExecutor;
+}
+
+inline size_t& parallel_executor::sCurrentIndex() {
+  static thread_local size_t sIndex = 0;
+  return sIndex;
+}
+
+/* Workers use their own deque, any other thread uses the first one. */
+inline size_t parallel_executor::DoSelf() const {
+  return sCurrentExecutor() == this ? sCurrentIndex() : 0;
+}
+
+inline void parallel_executor::spawn(task_type task) {
+  Worker& worker = *mWorkers[DoSelf()];
+
+  ++mPending;
+  ++mQueued;
+  {
+    std::lock_guard<std::mutex> lock(worker.mMutex);
+    worker.mTasks.push_back(LIB::move(task));
+  }
+
+  /* Taking the lock orders the notification after a worker checking
+     mQueued and going to sleep. */
+  { std::lock_guard<std::mutex> lock(mSleepMutex); }
+  mWake.notify_one();
+}
+
+inline void parallel_executor::wait() {
+  const size_t self = DoSelf();
+
+  while (mPending.load() != 0) {
+    if (!DoRunOne(self))
+      std::this_thread::yield();
+  }
+}
+
+inline bool parallel_executor::DoRunOne(size_t self) {
+  const size_t count = mWorkers.size();
+  task_type task;
+  bool found = false;
+
+  {
+    Worker& own = *mWorkers[self];
+    std::lock_guard<std::mutex> lock(own.mMutex);
+    if (!own.mTasks.empty()) {
+      task = LIB::move(own.mTasks.back());
+      own.mTasks.pop_back();
+      found = true;
+    }
+  }
+
+  for (size_t i = 1; !found && i < count; ++i) {
+    Worker& victim = *mWorkers[(self + i) % count];
+    std::lock_guard<std::mutex> lock(victim.mMutex);
+    if (!victim.mTasks.empty()) {
+      task = LIB::move(victim.mTasks.front());
+      victim.mTasks.pop_front();
+      found = true;
+    }
+  }
+
+  if (!found)
+    return false;
+
+  --mQueued;
+  task();
+  --mPending;
+  return true;
+}
+
+inline void parallel_executor::DoWorkerLoop(size_t self) {
+  sCurrentExecutor() = this;
+  sCurrentIndex() = self;
+
+  for (;;) {
+    if (DoRunOne(self))
+      continue;
+
+    std::unique_lock<std::mutex> lock(mSleepMutex);
+    mWake.wait(lock, [this] { return mStop || mQueued.load() != 0; });
+    if (mStop && mQueued.load() == 0)
+      return;
+  }
+}
+
+}  // namespace jnstl
+
+#endif /* JNSTL_EXECUTOR_H_ */
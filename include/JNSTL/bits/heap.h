@@ -1,6 +1,8 @@
 #ifndef JNSTL_HEAP_H_
 #define JNSTL_HEAP_H_
 
+#include <type_traits>
+
 #include "JNSTL/bits/config.h"
 
 namespace jnstl {
@@ -100,6 +102,212 @@ make_heap_impl(RandomIt first, RandomIt last, Compare comp) {
   }
 }
 
+/* Prefetches the element it refers to. Iterators whose reference is a
+   proxy have no address to give. */
+template <typename RandomIt>
+inline void
+heap_prefetch(RandomIt it, std::true_type) {
+  JNSTL_PREFETCH(&*it);
+}
+
+template <typename RandomIt>
+inline void
+heap_prefetch(RandomIt, std::false_type) {}
+
+/* Heaps of Arity children per node: the children of Idx are the Arity
+   elements from Arity * Idx + 1, next to each other in memory, so they
+   span one or two cache lines. The tree is log2(Arity) times shallower
+   than a binary heap: a push compares an element per level, and a pop
+   compares the Arity children of a level, by a tournament, while the
+   children of all of them are prefetched. The loads of a level then no
+   longer wait for the comparisons of the level above. */
+template <size_t Arity>
+struct dary_heap {
+  static_assert(Arity >= 2, "a heap node needs at least two children");
+
+  template <typename RandomIt, typename Distance, typename T,
+            typename Compare>
+  static void
+  promote(RandomIt first, Distance Idx, Distance topIdx, T val,
+          Compare comp) {
+    Distance parentIdx = (Idx - 1) / Distance(Arity);
+
+    for (; Idx > topIdx && comp(*(first + parentIdx), val);
+         parentIdx = (Idx - 1) / Distance(Arity)) {
+      *(first + Idx) = LIB::move(*(first + parentIdx));
+      Idx = parentIdx;
+    }
+    *(first + Idx) = LIB::move(val);
+  }
+
+  /* Elements of type T per cache line */
+  template <typename T>
+  static constexpr size_t
+  line_elements() {
+    return sizeof(T) < JNSTL_CACHE_LINE_SIZE
+        ? JNSTL_CACHE_LINE_SIZE / sizeof(T) : 1;
+  }
+
+  /* Index of the largest of the Count elements from children + base, by a
+     tournament: the matches of a round are independent of each other and
+     their outcome selects the winner arithmetically. */
+  template <size_t Count, typename RandomIt, typename Distance,
+            typename Compare>
+  static Distance
+  largest_child(RandomIt children, Distance base, Compare comp,
+                typename std::enable_if<(Count > 1)>::type* = 0) {
+    const Distance a = dary_heap::largest_child<Count / 2>(children, base,
+                                                           comp);
+    const Distance b = dary_heap::largest_child<Count - Count / 2>(
+        children, base + Distance(Count / 2), comp);
+    const Distance smaller = comp(*(children + a), *(children + b));
+
+    return a ^ ((a ^ b) & -smaller);
+  }
+
+  template <size_t Count, typename RandomIt, typename Distance,
+            typename Compare>
+  static Distance
+  largest_child(RandomIt, Distance base, Compare,
+                typename std::enable_if<(Count == 1)>::type* = 0) {
+    return base;
+  }
+
+  /* Same approach as adjust_heap: the hole moves down to the largest child
+     until the bottom, then val is promoted from there. */
+  template <typename RandomIt, typename Distance, typename T,
+            typename Compare>
+  static void
+  adjust(RandomIt first, Distance Idx, Distance heapSize, T val,
+         Compare comp) {
+    typedef std::is_reference<
+        typename jnstl::iterator_traits<RandomIt>::reference> addressable;
+
+    const Distance topIdx = Idx;
+    Distance childIdx = Distance(Arity) * Idx + 1;
+
+    while (childIdx + Distance(Arity) <= heapSize) {
+      const Distance grandIdx = Distance(Arity) * childIdx + 1;
+
+      if (grandIdx + Distance(Arity * Arity) <= heapSize) {
+        for (size_t i = 0; i < Arity * Arity; i += line_elements<T>())
+          jnstl::heap_prefetch(first + grandIdx + Distance(i),
+                               addressable());
+      }
+      const Distance largest =
+          dary_heap::largest_child<Arity>(first, childIdx, comp);
+
+      *(first + Idx) = LIB::move(*(first + largest));
+      Idx = largest;
+      childIdx = Distance(Arity) * Idx + 1;
+    }
+
+    /* The last parent may have less than Arity children */
+    if (childIdx < heapSize) {
+      Distance largest = childIdx;
+
+      for (Distance i = childIdx + 1; i < heapSize; ++i) {
+        if (comp(*(first + largest), *(first + i)))
+          largest = i;
+      }
+      *(first + Idx) = LIB::move(*(first + largest));
+      Idx = largest;
+    }
+    dary_heap::promote(first, Idx, topIdx, LIB::move(val), comp);
+  }
+
+  template <typename RandomIt, typename Compare>
+  static void
+  pop(RandomIt first, RandomIt last, RandomIt result, Compare comp) {
+    typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+    typedef typename
+        jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+    value_type val = LIB::move(*result);
+    *result = LIB::move(*first);
+    dary_heap::adjust(first, difference_type(0),
+                      difference_type(last - first), LIB::move(val), comp);
+  }
+
+  template <typename RandomIt, typename Compare>
+  static void
+  make(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+    typedef typename
+        jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+    const difference_type heapSize = last - first;
+
+    if (heapSize < 2)
+      return;
+    for (difference_type parentIdx = (heapSize - 2) / difference_type(Arity);
+         parentIdx >= 0; --parentIdx) {
+      value_type val = LIB::move(*(first + parentIdx));
+
+      dary_heap::adjust(first, parentIdx, heapSize, LIB::move(val), comp);
+    }
+  }
+};
+
+/* The binary heap keeps its own functions */
+template <>
+struct dary_heap<2> {
+  template <typename RandomIt, typename Distance, typename T,
+            typename Compare>
+  static void
+  promote(RandomIt first, Distance Idx, Distance topIdx, T val,
+          Compare comp) {
+    jnstl::promote_heap(first, Idx, topIdx, LIB::move(val), comp);
+  }
+
+  template <typename RandomIt, typename Distance, typename T,
+            typename Compare>
+  static void
+  adjust(RandomIt first, Distance Idx, Distance heapSize, T val,
+         Compare comp) {
+    jnstl::adjust_heap(first, Idx, heapSize, LIB::move(val), comp);
+  }
+
+  template <typename RandomIt, typename Compare>
+  static void
+  pop(RandomIt first, RandomIt last, RandomIt result, Compare comp) {
+    jnstl::pop_heap_impl(first, last, result, comp);
+  }
+
+  template <typename RandomIt, typename Compare>
+  static void
+  make(RandomIt first, RandomIt last, Compare comp) {
+    jnstl::make_heap_impl(first, last, comp);
+  }
+};
+
+/* Adds the elements of [middle, last) to the heap [first, middle). Every
+   promotion may climb the whole heap, as when the batch comes in order of
+   priority, while rebuilding it bottom-up costs a few comparisons per
+   element of [first, last) whatever the order: batches at least as large as
+   the heap are rebuilt, the others promoted one by one, which costs little
+   for keys in random order. */
+template <size_t Arity, typename RandomIt, typename Compare>
+void
+heap_push_range(RandomIt first, RandomIt middle, RandomIt last,
+                Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  if (last - middle >= middle - first) {
+    jnstl::dary_heap<Arity>::make(first, last, comp);
+    return;
+  }
+  for (; middle != last; ++middle) {
+    value_type val = LIB::move(*middle);
+
+    jnstl::dary_heap<Arity>::promote(first, difference_type(middle - first),
+                                     difference_type(0), LIB::move(val),
+                                     comp);
+  }
+}
+
 template <typename RandomIt, typename Compare>
 void
 heap_select(RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
@@ -0,0 +1,741 @@
+#ifndef JNSTL_MERGE_SORT_H_
+#define JNSTL_MERGE_SORT_H_
+
+#include "JNSTL/bits/config.h"
+#include "JNSTL/bits/construct.h"
+#include "JNSTL/bits/tempbuf.h"
+#include "JNSTL/iterator.h"
+
+namespace jnstl {
+
+template <typename InputIterator, typename OutputIterator>
+OutputIterator
+move(InputIterator first, InputIterator last, OutputIterator d_first);
+
+template <typename BidirectionalIterator1, typename BidirectionalIterator2>
+BidirectionalIterator2
+move_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
+              BidirectionalIterator2 d_last);
+
+template <typename ForwardIt1, typename ForwardIt2>
+void
+iter_swap(ForwardIt1 a, ForwardIt2 b);
+
+template <typename RandomIt, typename Compare>
+void
+insertion_sort(RandomIt first, RandomIt last, Compare comp);
+
+/* Merges switch to galloping once one side wins this many times in a row */
+const int merge_min_gallop = 7;
+
+/* Runs shorter than this are extended with an insertion sort */
+const ptrdiff_t merge_min_run = 24;
+
+/* First element of [first, last) for which pred is false, pred being true
+   then false along the range. */
+template <typename RandomIt, typename Predicate>
+RandomIt
+merge_partition_point(RandomIt first, RandomIt last, Predicate pred) {
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  difference_type len = last - first;
+
+  while (len > 0) {
+    const difference_type half = len / 2;
+    const RandomIt mid = first + half;
+
+    if (pred(*mid)) {
+      first = mid + 1;
+      len -= half + 1;
+    } else {
+      len = half;
+    }
+  }
+  return first;
+}
+
+/* merge_partition_point probing 1, 3, 7, ... elements from first before the
+   binary search, cheap when the answer is close to first. */
+template <typename RandomIt, typename Predicate>
+RandomIt
+gallop_from_first(RandomIt first, RandomIt last, Predicate pred) {
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  const difference_type n = last - first;
+
+  if (n == 0 || !pred(*first))
+    return first;
+
+  difference_type lastOfs = 0;
+  difference_type ofs = 1;
+
+  while (ofs < n && pred(*(first + ofs))) {
+    lastOfs = ofs;
+    ofs = 2 * ofs + 1;
+  }
+  if (ofs > n)
+    ofs = n;
+
+  return jnstl::merge_partition_point(first + (lastOfs + 1), first + ofs,
+                                      pred);
+}
+
+/* Same as gallop_from_first, probing from last */
+template <typename RandomIt, typename Predicate>
+RandomIt
+gallop_from_last(RandomIt first, RandomIt last, Predicate pred) {
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  const difference_type n = last - first;
+
+  if (n == 0 || pred(*(last - 1)))
+    return last;
+
+  difference_type lastOfs = 0;
+  difference_type ofs = 1;
+
+  while (ofs < n && !pred(*(last - 1 - ofs))) {
+    lastOfs = ofs;
+    ofs = 2 * ofs + 1;
+  }
+  if (ofs > n)
+    ofs = n;
+
+  return jnstl::merge_partition_point(last - ofs, last - 1 - lastOfs, pred);
+}
+
+/* Merges [first, middle) and [middle, last), the first run being moved to
+   buffer. Runs from the front, switching to galloping while one run keeps
+   winning. minGallop adapts to how well galloping pays off. */
+template <typename RandomIt, typename Pointer, typename Compare>
+void
+merge_lo(RandomIt first, RandomIt middle, RandomIt last, Pointer buffer,
+         Compare comp, int& minGallop) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+  Pointer b = buffer;
+  Pointer bEnd = jnstl::move(first, middle, buffer);
+  RandomIt r = middle;
+  RandomIt out = first;
+
+  while (true) {
+    int count1 = 0;
+    int count2 = 0;
+
+    do {
+      if (comp(*r, *b)) {
+        *out = LIB::move(*r);
+        ++out;
+        ++r;
+        ++count2;
+        count1 = 0;
+        if (r == last)
+          goto done;
+      } else {
+        *out = LIB::move(*b);
+        ++out;
+        ++b;
+        ++count1;
+        count2 = 0;
+        if (b == bEnd)
+          goto done;
+      }
+    } while ((count1 | count2) < minGallop);
+
+    do {
+      const value_type& rv = *r;
+      Pointer bCut = jnstl::gallop_from_first(
+          b, bEnd, [&](const value_type& x) { return !comp(rv, x); });
+      count1 = static_cast<int>(bCut - b);
+      out = jnstl::move(b, bCut, out);
+      b = bCut;
+      if (b == bEnd)
+        goto done;
+
+      *out = LIB::move(*r);
+      ++out;
+      ++r;
+      if (r == last)
+        goto done;
+
+      const value_type& bv = *b;
+      RandomIt rCut = jnstl::gallop_from_first(
+          r, last, [&](const value_type& x) { return comp(x, bv); });
+      count2 = static_cast<int>(rCut - r);
+      out = jnstl::move(r, rCut, out);
+      r = rCut;
+      if (r == last)
+        goto done;
+
+      *out = LIB::move(*b);
+      ++out;
+      ++b;
+      if (b == bEnd)
+        goto done;
+
+      if (minGallop > 1)
+        --minGallop;
+    } while (count1 >= merge_min_gallop || count2 >= merge_min_gallop);
+    ++minGallop;
+  }
+
+done:
+  /* What is left of the second run is already in place */
+  jnstl::move(b, bEnd, out);
+}
+
+/* Mirror of merge_lo moving the second run to buffer and merging from the
+   back. */
+template <typename RandomIt, typename Pointer, typename Compare>
+void
+merge_hi(RandomIt first, RandomIt middle, RandomIt last, Pointer buffer,
+         Compare comp, int& minGallop) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+  Pointer bFirst = buffer;
+  Pointer b = jnstl::move(middle, last, buffer);
+  RandomIt l = middle;
+  RandomIt out = last;
+
+  while (true) {
+    int count1 = 0;
+    int count2 = 0;
+
+    do {
+      if (comp(*(b - 1), *(l - 1))) {
+        --out;
+        --l;
+        *out = LIB::move(*l);
+        ++count1;
+        count2 = 0;
+        if (l == first)
+          goto done;
+      } else {
+        --out;
+        --b;
+        *out = LIB::move(*b);
+        ++count2;
+        count1 = 0;
+        if (b == bFirst)
+          goto done;
+      }
+    } while ((count1 | count2) < minGallop);
+
+    do {
+      const value_type& bv = *(b - 1);
+      RandomIt lCut = jnstl::gallop_from_last(
+          first, l, [&](const value_type& x) { return !comp(bv, x); });
+      count1 = static_cast<int>(l - lCut);
+      out = jnstl::move_backward(lCut, l, out);
+      l = lCut;
+      if (l == first)
+        goto done;
+
+      --out;
+      --b;
+      *out = LIB::move(*b);
+      if (b == bFirst)
+        goto done;
+
+      const value_type& lv = *(l - 1);
+      Pointer bCut = jnstl::gallop_from_last(
+          bFirst, b, [&](const value_type& x) { return comp(x, lv); });
+      count2 = static_cast<int>(b - bCut);
+      out = jnstl::move_backward(bCut, b, out);
+      b = bCut;
+      if (b == bFirst)
+        goto done;
+
+      --out;
+      --l;
+      *out = LIB::move(*l);
+      if (l == first)
+        goto done;
+
+      if (minGallop > 1)
+        --minGallop;
+    } while (count1 >= merge_min_gallop || count2 >= merge_min_gallop);
+    ++minGallop;
+  }
+
+done:
+  /* What is left of the first run is already in place */
+  jnstl::move_backward(bFirst, b, out);
+}
+
+/* Reverses [first, last) */
+template <typename BidirIt>
+void
+merge_reverse(BidirIt first, BidirIt last) {
+  while (first != last && first != --last) {
+    jnstl::iter_swap(first, last);
+    ++first;
+  }
+}
+
+/* Rotates [first, last) so that middle becomes the first element, through
+   buffer when the shorter side fits in it. Returns the new position of
+   first. Only needs bidirectional iterators. */
+template <typename BidirIt, typename Pointer, typename Distance>
+BidirIt
+merge_rotate(BidirIt first, BidirIt middle, BidirIt last,
+             Distance len1, Distance len2, Pointer buffer,
+             Distance bufferSize) {
+  if (len2 <= bufferSize && len2 <= len1) {
+    if (len2 == 0)
+      return first;
+    Pointer bEnd = jnstl::move(middle, last, buffer);
+    jnstl::move_backward(first, middle, last);
+    return jnstl::move(buffer, bEnd, first);
+  } else if (len1 <= bufferSize) {
+    if (len1 == 0)
+      return last;
+    Pointer bEnd = jnstl::move(first, middle, buffer);
+    jnstl::move(middle, last, first);
+    return jnstl::move_backward(buffer, bEnd, last);
+  }
+
+  jnstl::merge_reverse(first, middle);
+  jnstl::merge_reverse(middle, last);
+  jnstl::merge_reverse(first, last);
+  for (; len2 > 0; --len2)
+    ++first;
+  return first;
+}
+
+/* Stable merge of [first, middle) and [middle, last) with a buffer of
+   bufferSize elements, possibly 0. When the shorter run fits in the buffer
+   it is a single merge_lo or merge_hi, otherwise the longer run is cut in
+   half, the matching position found in the other one by binary search,
+   the two inner pieces swapped by a rotation and both halves merged
+   recursively: O(n log n) without any buffer. */
+template <typename RandomIt, typename Pointer, typename Distance,
+          typename Compare>
+void
+merge_adaptive(RandomIt first, RandomIt middle, RandomIt last,
+               Distance len1, Distance len2, Pointer buffer,
+               Distance bufferSize, Compare comp, int& minGallop) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+  if (len1 == 0 || len2 == 0)
+    return;
+
+  if (len1 <= len2 && len1 <= bufferSize) {
+    jnstl::merge_lo(first, middle, last, buffer, comp, minGallop);
+    return;
+  }
+  if (len2 <= bufferSize) {
+    jnstl::merge_hi(first, middle, last, buffer, comp, minGallop);
+    return;
+  }
+
+  if (len1 + len2 == 2) {
+    if (comp(*middle, *first))
+      jnstl::iter_swap(first, middle);
+    return;
+  }
+
+  RandomIt cut1;
+  RandomIt cut2;
+  Distance len11;
+  Distance len22;
+
+  if (len1 > len2) {
+    len11 = len1 / 2;
+    cut1 = first + len11;
+    const value_type& v = *cut1;
+    cut2 = jnstl::merge_partition_point(middle, last,
+                                        [&](const value_type& x) {
+      return comp(x, v);
+    });
+    len22 = cut2 - middle;
+  } else {
+    len22 = len2 / 2;
+    cut2 = middle + len22;
+    const value_type& v = *cut2;
+    cut1 = jnstl::merge_partition_point(first, middle,
+                                        [&](const value_type& x) {
+      return !comp(v, x);
+    });
+    len11 = cut1 - first;
+  }
+
+  const RandomIt newMiddle =
+      jnstl::merge_rotate(cut1, middle, cut2, Distance(len1 - len11), len22,
+                          buffer, bufferSize);
+
+  jnstl::merge_adaptive(first, cut1, newMiddle, len11, len22,
+                        buffer, bufferSize, comp, minGallop);
+  jnstl::merge_adaptive(newMiddle, cut2, last, Distance(len1 - len11),
+                        Distance(len2 - len22), buffer, bufferSize, comp,
+                        minGallop);
+}
+
+/* Merges two adjacent sorted runs, first trimming the elements already in
+   their final position: the head of the first run not greater than the
+   head of the second, and the tail of the second run not less than the
+   tail of the first. */
+template <typename RandomIt, typename Pointer, typename Distance,
+          typename Compare>
+void
+merge_runs(RandomIt first, RandomIt middle, RandomIt last, Pointer buffer,
+           Distance bufferSize, Compare comp, int& minGallop) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+  const value_type& head2 = *middle;
+  first = jnstl::gallop_from_first(first, middle, [&](const value_type& x) {
+    return !comp(head2, x);
+  });
+  if (first == middle)
+    return;
+
+  const value_type& tail1 = *(middle - 1);
+  last = jnstl::gallop_from_last(middle, last, [&](const value_type& x) {
+    return comp(x, tail1);
+  });
+
+  jnstl::merge_adaptive(first, middle, last, Distance(middle - first),
+                        Distance(last - middle), buffer, bufferSize, comp,
+                        minGallop);
+}
+
+/* Advances first by the number of leading elements of [first, first + len)
+   for which pred is true, pred being true then false along the range, and
+   returns that number. Binary search on the comparisons for bidirectional
+   iterators, the steps stay linear. */
+template <typename BidirIt, typename Distance, typename Predicate>
+Distance
+merge_partition_point_n(BidirIt& first, Distance len, Predicate pred) {
+  Distance count = 0;
+
+  while (len > 0) {
+    const Distance half = len / 2;
+    BidirIt mid = first;
+
+    for (Distance i = 0; i < half; ++i)
+      ++mid;
+
+    if (pred(*mid)) {
+      first = ++mid;
+      count += half + 1;
+      len -= half + 1;
+    } else {
+      len = half;
+    }
+  }
+  return count;
+}
+
+/* Plain merge_lo for bidirectional iterators, without galloping */
+template <typename BidirIt, typename Pointer, typename Compare>
+void
+merge_forward_buffer(BidirIt first, BidirIt middle, BidirIt last,
+                     Pointer buffer, Compare comp) {
+  Pointer b = buffer;
+  Pointer bEnd = jnstl::move(first, middle, buffer);
+  BidirIt r = middle;
+  BidirIt out = first;
+
+  while (b != bEnd && r != last) {
+    if (comp(*r, *b)) {
+      *out = LIB::move(*r);
+      ++r;
+    } else {
+      *out = LIB::move(*b);
+      ++b;
+    }
+    ++out;
+  }
+  jnstl::move(b, bEnd, out);
+}
+
+/* Plain merge_hi for bidirectional iterators, without galloping */
+template <typename BidirIt, typename Pointer, typename Compare>
+void
+merge_backward_buffer(BidirIt first, BidirIt middle, BidirIt last,
+                      Pointer buffer, Compare comp) {
+  Pointer b = jnstl::move(middle, last, buffer);
+  BidirIt l = middle;
+  BidirIt out = last;
+
+  while (b != buffer && l != first) {
+    BidirIt prev = l;
+    --prev;
+    --out;
+    if (comp(*(b - 1), *prev)) {
+      *out = LIB::move(*prev);
+      l = prev;
+    } else {
+      --b;
+      *out = LIB::move(*b);
+    }
+  }
+  jnstl::move_backward(buffer, b, out);
+}
+
+/* merge_adaptive for bidirectional iterators: same buffered merges and
+   rotation fallback, the cuts found by merge_partition_point_n. */
+template <typename BidirIt, typename Pointer, typename Distance,
+          typename Compare>
+void
+merge_adaptive_bidir(BidirIt first, BidirIt middle, BidirIt last,
+                     Distance len1, Distance len2, Pointer buffer,
+                     Distance bufferSize, Compare comp) {
+  typedef typename jnstl::iterator_traits<BidirIt>::value_type value_type;
+
+  if (len1 == 0 || len2 == 0)
+    return;
+
+  if (len1 <= len2 && len1 <= bufferSize) {
+    jnstl::merge_forward_buffer(first, middle, last, buffer, comp);
+    return;
+  }
+  if (len2 <= bufferSize) {
+    jnstl::merge_backward_buffer(first, middle, last, buffer, comp);
+    return;
+  }
+
+  if (len1 + len2 == 2) {
+    if (comp(*middle, *first))
+      jnstl::iter_swap(first, middle);
+    return;
+  }
+
+  BidirIt cut1 = first;
+  BidirIt cut2 = middle;
+  Distance len11;
+  Distance len22;
+
+  if (len1 > len2) {
+    len11 = len1 / 2;
+    for (Distance i = 0; i < len11; ++i)
+      ++cut1;
+    const value_type& v = *cut1;
+    len22 = jnstl::merge_partition_point_n(cut2, len2,
+                                           [&](const value_type& x) {
+      return comp(x, v);
+    });
+  } else {
+    len22 = len2 / 2;
+    for (Distance i = 0; i < len22; ++i)
+      ++cut2;
+    const value_type& v = *cut2;
+    len11 = jnstl::merge_partition_point_n(cut1, len1,
+                                           [&](const value_type& x) {
+      return !comp(v, x);
+    });
+  }
+
+  const BidirIt newMiddle =
+      jnstl::merge_rotate(cut1, middle, cut2, Distance(len1 - len11), len22,
+                          buffer, bufferSize);
+
+  jnstl::merge_adaptive_bidir(first, cut1, newMiddle, len11, len22,
+                              buffer, bufferSize, comp);
+  jnstl::merge_adaptive_bidir(newMiddle, cut2, last, Distance(len1 - len11),
+                              Distance(len2 - len22), buffer, bufferSize,
+                              comp);
+}
+
+/* inplace_merge on bidirectional iterators. The buffer only has to hold
+   the shorter run, merge_adaptive_bidir rotates its way through with less
+   or none. */
+template <bool RandomAccess>
+struct inplace_merge_impl {
+  template <typename BidirIt, typename Compare>
+  static void
+  merge(BidirIt first, BidirIt middle, BidirIt last, Compare comp) {
+    typedef typename jnstl::iterator_traits<BidirIt>::value_type value_type;
+
+    ptrdiff_t len1 = 0;
+    ptrdiff_t len2 = 0;
+
+    for (BidirIt it = first; it != middle; ++it)
+      ++len1;
+    for (BidirIt it = middle; it != last; ++it)
+      ++len2;
+
+    jnstl::pair<value_type*, ptrdiff_t> buffer =
+        jnstl::get_temporary_buffer<value_type>(len1 < len2 ? len1 : len2);
+
+    if (buffer.first != nullptr)
+      jnstl::uninitialized_construct_buf(buffer.first,
+                                         buffer.first + buffer.second, first);
+
+    jnstl::merge_adaptive_bidir(first, middle, last, len1, len2,
+                                buffer.first, buffer.second, comp);
+
+    jnstl::Destruct(buffer.first, buffer.first + buffer.second);
+    jnstl::return_temporary_buffer(buffer.first);
+  }
+};
+
+/* Random access iterators: the runs are trimmed before sizing the buffer,
+   then merged with galloping. */
+template <>
+struct inplace_merge_impl<true> {
+  template <typename RandomIt, typename Compare>
+  static void
+  merge(RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
+    typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+    typedef typename
+        jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+    const value_type& head2 = *middle;
+    first = jnstl::gallop_from_first(first, middle, [&](const value_type& x) {
+      return !comp(head2, x);
+    });
+    if (first == middle)
+      return;
+
+    const value_type& tail1 = *(middle - 1);
+    last = jnstl::gallop_from_last(middle, last, [&](const value_type& x) {
+      return comp(x, tail1);
+    });
+
+    const difference_type len1 = middle - first;
+    const difference_type len2 = last - middle;
+    int minGallop = merge_min_gallop;
+
+    jnstl::pair<value_type*, ptrdiff_t> buffer =
+        jnstl::get_temporary_buffer<value_type>(len1 < len2 ? len1 : len2);
+
+    if (buffer.first != nullptr)
+      jnstl::uninitialized_construct_buf(buffer.first,
+                                         buffer.first + buffer.second, first);
+
+    jnstl::merge_adaptive(first, middle, last, len1, len2, buffer.first,
+                          difference_type(buffer.second), comp, minGallop);
+
+    jnstl::Destruct(buffer.first, buffer.first + buffer.second);
+    jnstl::return_temporary_buffer(buffer.first);
+  }
+};
+
+/* Powersort merge policy: the power of the boundary between the runs
+   [s1, s1 + n1) and [s1 + n1, s1 + n1 + n2) of a range of n elements is
+   the depth at which the boundary would split the range in a perfectly
+   balanced merge tree, based on the run midpoints. */
+template <typename Distance>
+int
+merge_node_power(Distance s1, Distance n1, Distance n2, Distance n) {
+  Distance a = 2 * s1 + n1;
+  Distance b = a + n1 + n2;
+  int power = 0;
+
+  while (true) {
+    ++power;
+    if (a >= n) {
+      a -= n;
+      b -= n;
+    } else if (b >= n) {
+      break;
+    }
+    a <<= 1;
+    b <<= 1;
+  }
+  return power;
+}
+
+/* Finds the run starting at first, reversing it if strictly descending,
+   and extends it to min(merge_min_run, last - first) elements. */
+template <typename RandomIt, typename Compare>
+RandomIt
+merge_next_run(RandomIt first, RandomIt last, Compare comp) {
+  RandomIt runEnd = first + 1;
+
+  if (runEnd == last)
+    return last;
+
+  if (comp(*runEnd, *first)) {
+    ++runEnd;
+    while (runEnd != last && comp(*runEnd, *(runEnd - 1)))
+      ++runEnd;
+    /* Strictly descending, reversing keeps equal elements in order */
+    jnstl::merge_reverse(first, runEnd);
+  } else {
+    ++runEnd;
+    while (runEnd != last && !comp(*runEnd, *(runEnd - 1)))
+      ++runEnd;
+  }
+
+  if (runEnd - first < merge_min_run) {
+    const RandomIt minEnd = last - first < merge_min_run ?
+        last : first + merge_min_run;
+    jnstl::insertion_sort(first, minEnd, comp);
+    runEnd = minEnd;
+  }
+  return runEnd;
+}
+
+/* Adaptive stable merge sort (powersort). Natural ascending and strictly
+   descending runs are detected, short ones extended by insertion sort,
+   and merged as dictated by their powers, which keeps the merges
+   balanced; presorted input costs O(n). Merges gallop, and use buffer of
+   bufferSize elements, ideally half the range: with less, or none,
+   merge_adaptive falls back on rotations. */
+template <typename RandomIt, typename Pointer, typename Distance,
+          typename Compare>
+void
+merge_sort_adaptive(RandomIt first, RandomIt last, Pointer buffer,
+                    Distance bufferSize, Compare comp) {
+  struct Run {
+    Distance mStart;
+    Distance mLength;
+    int      mPower;
+  };
+
+  const Distance n = last - first;
+  /* Powers are strictly increasing along the stack and bounded by the
+     number of bits of n */
+  Run stack[sizeof(Distance) * 8 + 2];
+  int top = 0;
+  int minGallop = merge_min_gallop;
+  Distance start = 0;
+
+  while (start < n) {
+    const Distance length =
+        jnstl::merge_next_run(first + start, last, comp) - (first + start);
+
+    if (top > 0) {
+      const int power = jnstl::merge_node_power(
+          stack[top - 1].mStart, stack[top - 1].mLength, length, n);
+
+      while (top > 1 && stack[top - 2].mPower > power) {
+        Run& lhs = stack[top - 2];
+        const Run& rhs = stack[top - 1];
+
+        jnstl::merge_runs(first + lhs.mStart, first + rhs.mStart,
+                          first + (rhs.mStart + rhs.mLength),
+                          buffer, bufferSize, comp, minGallop);
+        lhs.mLength += rhs.mLength;
+        --top;
+      }
+      stack[top - 1].mPower = power;
+    }
+
+    stack[top].mStart = start;
+    stack[top].mLength = length;
+    stack[top].mPower = 0;
+    ++top;
+    start += length;
+  }
+
+  while (top > 1) {
+    Run& lhs = stack[top - 2];
+    const Run& rhs = stack[top - 1];
+
+    jnstl::merge_runs(first + lhs.mStart, first + rhs.mStart,
+                      first + (rhs.mStart + rhs.mLength),
+                      buffer, bufferSize, comp, minGallop);
+    lhs.mLength += rhs.mLength;
+    --top;
+  }
+}
+
+}  // namespace jnstl
+
+#endif /* JNSTL_MERGE_SORT_H_ */
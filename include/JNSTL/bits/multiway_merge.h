@@ -0,0 +1,269 @@
+#ifndef JNSTL_MULTIWAY_MERGE_H_
+#define JNSTL_MULTIWAY_MERGE_H_
+
+#include <type_traits>
+
+#include "JNSTL/bits/config.h"
+#include "JNSTL/bits/construct.h"
+#include "JNSTL/allocator.h"
+#include "JNSTL/iterator.h"
+#include "JNSTL/utility.h"
+
+namespace jnstl {
+
+template <typename InputIterator, typename OutputIterator>
+OutputIterator
+copy(InputIterator first, InputIterator last, OutputIterator d_first);
+
+template <typename InputIt1, typename InputIt2, typename OutputIt,
+          typename Compare>
+OutputIt
+merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
+      OutputIt d_first, Compare comp);
+
+/* The iterator type of the input ranges of a multiway merge, given as
+   pairs of iterators (jnstl::pair or std::pair) */
+template <typename SeqIt>
+struct multiway_source {
+  typedef typename std::decay<decltype(
+      LIB::declval<SeqIt>()->first)>::type iterator;
+  typedef jnstl::pair<iterator, iterator> range;
+};
+
+/**
+ * Loser tree (tournament tree) over the heads of k non-empty ranges.
+ *
+ * The leaves are the nodes k to 2k - 1 of an implicit binary tree, every
+ * inner node keeps the loser of the match played there and mTree[0] the
+ * overall winner. Once the winner has been output and its range advanced,
+ * only the matches on its path to the root are replayed: about log2(k)
+ * comparisons per element, against the 2 log2(k) of a binary heap.
+ * Nodes hold the head of their range next to its index, so the nodes of a
+ * path can be loaded before the outcome of the matches below them is
+ * known, and that outcome indexes the two contenders instead of being
+ * branched on. Ranges running out are removed by the caller, which
+ * rebuilds the tree, so matches never check for exhausted ranges.
+ * The ranges are assigned to the leaves in in-order, every range in a left
+ * subtree precedes the ones in the right subtree. The Stable variant lets
+ * the contender coming from the left win ties, equal elements then come
+ * out in the order of their ranges, and which side that is only depends
+ * on the path.
+ */
+template <bool Stable, typename It, typename Compare>
+class loser_tree {
+ public:
+  struct Node {
+    It  mHead;
+    int mSource;
+  };
+
+  /* tree holds k nodes, leaves k ints */
+  loser_tree(const jnstl::pair<It, It>* ranges, int k, Node* tree,
+             int* leaves, Compare comp)
+      : mTree(tree),
+        mLeafOf(leaves),
+        mLeaves(k),
+        mComp(comp) {
+    int next = 0;
+    mTree[0] = DoInit(ranges, 1, next);
+  }
+
+  const Node& winner() const {
+    return mTree[0];
+  }
+
+  /* Replays the matches of the winner, whose range now starts at head */
+  void replay(It head) {
+    int source = mTree[0].mSource;
+
+    for (int child = mLeafOf[source]; child > 1; child /= 2) {
+      Node& slot = mTree[child / 2];
+      const It heads[2] = { head, slot.mHead };
+      const int sources[2] = { source, slot.mSource };
+      const int lost = DoBeats(slot.mHead, head, child & 1);
+
+      slot.mHead = heads[1 - lost];
+      slot.mSource = sources[1 - lost];
+      head = heads[lost];
+      source = sources[lost];
+    }
+    mTree[0].mHead = head;
+    mTree[0].mSource = source;
+  }
+
+ private:
+  Node*   mTree;
+  int*    mLeafOf;
+  int     mLeaves;
+  Compare mComp;
+
+  /* Whether a beats b, a coming from the left subtree when fromRight is
+     set (b is the one from the right): ties then go to a in the Stable
+     variant, by negating the comparison with swapped operands. */
+  int DoBeats(It a, It b, int fromRight) {
+    const int swapped = Stable && fromRight;
+    const It lhs = swapped ? b : a;
+    const It rhs = swapped ? a : b;
+
+    return swapped ^ mComp(*lhs, *rhs);
+  }
+
+  Node DoInit(const jnstl::pair<It, It>* ranges, int node, int& next) {
+    if (node >= mLeaves) {
+      const Node leaf = { ranges[next].first, next };
+      mLeafOf[next] = node;
+      ++next;
+      return leaf;
+    }
+
+    const Node left = DoInit(ranges, 2 * node, next);
+    const Node right = DoInit(ranges, 2 * node + 1, next);
+
+    if (DoBeats(right.mHead, left.mHead, 0)) {
+      mTree[node] = left;
+      return right;
+    }
+    mTree[node] = right;
+    return left;
+  }
+};
+
+/* Merges the n ranges into d_first, advancing them. Empty ranges are
+   dropped first, and every range running out rebuilds the tree over the
+   others, preserving their order. The last two are merged by a plain
+   two-way merge, which is stable. */
+template <bool Stable, typename It, typename OutputIt, typename Compare>
+OutputIt
+multiway_merge_impl(jnstl::pair<It, It>* ranges, size_t n, OutputIt d_first,
+                    Compare comp) {
+  typedef jnstl::loser_tree<Stable, It, Compare> tree_type;
+  typedef typename tree_type::Node                node_type;
+
+  int k = 0;
+
+  for (size_t i = 0; i < n; ++i) {
+    if (ranges[i].first != ranges[i].second)
+      ranges[k++] = ranges[i];
+  }
+
+  if (k > 2) {
+    jnstl::allocator allocator;
+    node_type* const tree = static_cast<node_type*>(
+        allocator.allocate(k * sizeof(node_type)));
+    int* const leaves = static_cast<int*>(allocator.allocate(k * sizeof(int)));
+
+    const int size = k;
+
+    /* The nodes are assigned to while the tree is built */
+    for (int i = 0; i < size; ++i) {
+      const node_type node = { ranges[i].first, i };
+      jnstl::Construct(tree + i, node);
+    }
+
+    while (k > 2) {
+      tree_type losers(ranges, k, tree, leaves, comp);
+      int w;
+
+      while (true) {
+        const node_type& winner = losers.winner();
+        It head = winner.mHead;
+
+        w = winner.mSource;
+        *d_first = *head;
+        ++d_first;
+        if (++head == ranges[w].second)
+          break;
+        losers.replay(head);
+      }
+
+      /* Every range has its head in exactly one of the k first nodes */
+      for (int i = 0; i < k; ++i)
+        ranges[tree[i].mSource].first = tree[i].mHead;
+
+      for (int i = w; i + 1 < k; ++i)
+        ranges[i] = ranges[i + 1];
+      --k;
+    }
+
+    jnstl::Destruct(tree, tree + size);
+    allocator.deallocate(tree, size * sizeof(node_type));
+    allocator.deallocate(leaves, size * sizeof(int));
+  }
+
+  if (k == 2) {
+    d_first = jnstl::merge(ranges[0].first, ranges[0].second,
+                           ranges[1].first, ranges[1].second, d_first, comp);
+    ranges[0].first = ranges[0].second;
+    ranges[1].first = ranges[1].second;
+  } else if (k == 1) {
+    d_first = jnstl::copy(ranges[0].first, ranges[0].second, d_first);
+    ranges[0].first = ranges[0].second;
+  }
+  return d_first;
+}
+
+/* The cursors the loser tree advances, copied from the input ranges
+   [seqFirst, seqLast) into a buffer growing geometrically, as the number
+   of ranges is not known before they have been read. */
+template <typename SeqIt>
+class multiway_ranges {
+ public:
+  typedef typename jnstl::multiway_source<SeqIt>::range range;
+
+  multiway_ranges(SeqIt seqFirst, SeqIt seqLast)
+      : mRanges(nullptr),
+        mSize(0),
+        mCapacity(0) {
+    for (; seqFirst != seqLast; ++seqFirst) {
+      if (mSize == mCapacity)
+        DoGrow();
+      jnstl::Construct(mRanges + mSize,
+                       range(seqFirst->first, seqFirst->second));
+      ++mSize;
+    }
+  }
+
+  ~multiway_ranges() {
+    jnstl::Destruct(mRanges, mRanges + mSize);
+    if (mRanges != nullptr)
+      jnstl::allocator().deallocate(mRanges, mCapacity * sizeof(range));
+  }
+
+  range* data() {
+    return mRanges;
+  }
+
+  size_t size() const {
+    return mSize;
+  }
+
+ private:
+  range* mRanges;
+  size_t mSize;
+  size_t mCapacity;
+
+  multiway_ranges(const multiway_ranges&);
+
+  void
+  operator=(const multiway_ranges&);
+
+  void DoGrow() {
+    jnstl::allocator allocator;
+    const size_t capacity = mCapacity ? 2 * mCapacity : 8;
+    range* const ranges = static_cast<range*>(
+        allocator.allocate(capacity * sizeof(range)));
+
+    for (size_t i = 0; i < mSize; ++i)
+      jnstl::Construct(ranges + i, LIB::move(mRanges[i]));
+    jnstl::Destruct(mRanges, mRanges + mSize);
+    if (mRanges != nullptr)
+      allocator.deallocate(mRanges, mCapacity * sizeof(range));
+
+    mRanges   = ranges;
+    mCapacity = capacity;
+  }
+};
+
+}  // namespace jnstl
+
+#endif /* JNSTL_MULTIWAY_MERGE_H_ */
@@ -0,0 +1,322 @@
+#ifndef JNSTL_RADIX_SORT_H_
+#define JNSTL_RADIX_SORT_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "JNSTL/bits/config.h"
+#include "JNSTL/bits/construct.h"
+#include "JNSTL/bits/tempbuf.h"
+#include "JNSTL/iterator.h"
+
+namespace jnstl {
+
+template <typename RandomIt, typename Compare>
+void
+sort(RandomIt first, RandomIt last, Compare comp);
+
+/* Maps an arithmetic key to an unsigned integer with the same ordering,
+   the radix sort then works on its bytes. */
+template <typename T, typename Enable = void>
+struct radix_traits;
+
+/* Signed integers: flipping the sign bit moves the negative values below
+   the positive ones. */
+template <typename T>
+struct radix_traits<T, typename std::enable_if<
+                           std::is_integral<T>::value &&
+                           !std::is_same<T, bool>::value>::type> {
+  typedef typename std::make_unsigned<T>::type key_type;
+
+  static key_type
+  to_key(T value) {
+    const key_type sign = std::is_signed<T>::value ?
+        static_cast<key_type>(key_type(1) << (sizeof(T) * 8 - 1)) : 0;
+    return static_cast<key_type>(static_cast<key_type>(value) ^ sign);
+  }
+};
+
+/* IEEE floating point: positive values get their sign bit set, negative
+   ones have all their bits flipped so that larger magnitudes sort first. */
+template <typename T>
+struct radix_traits<T, typename std::enable_if<
+                           std::is_floating_point<T>::value>::type> {
+  static_assert(std::numeric_limits<T>::is_iec559 &&
+                (sizeof(T) == 4 || sizeof(T) == 8),
+                "radix_sort needs IEEE single or double precision keys");
+
+  typedef typename std::conditional<sizeof(T) == 4,
+                                    uint32_t, uint64_t>::type key_type;
+
+  static key_type
+  to_key(T value) {
+    key_type bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const key_type sign = key_type(1) << (sizeof(T) * 8 - 1);
+    return (bits & sign) ? key_type(~bits) : key_type(bits | sign);
+  }
+};
+
+struct radix_identity {
+  template <typename T>
+  const T&
+  operator()(const T& value) const {
+    return value;
+  }
+};
+
+template <typename T, typename KeyOf>
+struct radix_key_of {
+  typedef typename std::decay<decltype(
+      LIB::declval<const KeyOf&>()(LIB::declval<const T&>()))>::type key;
+  typedef radix_traits<key>             traits;
+  typedef typename traits::key_type     key_type;
+
+  static key_type
+  get(const KeyOf& keyOf, const T& value) {
+    return traits::to_key(keyOf(value));
+  }
+
+  static size_t
+  digit(const KeyOf& keyOf, const T& value, int d) {
+    return static_cast<size_t>((get(keyOf, value) >> (8 * d)) & 0xFF);
+  }
+};
+
+/* Comparison used on the ranges too small to be worth a radix pass */
+template <typename T, typename KeyOf>
+struct radix_key_less {
+  KeyOf mKeyOf;
+
+  explicit radix_key_less(const KeyOf& keyOf)
+      : mKeyOf(keyOf) {}
+
+  bool
+  operator()(const T& a, const T& b) const {
+    return radix_key_of<T, KeyOf>::get(mKeyOf, a) <
+           radix_key_of<T, KeyOf>::get(mKeyOf, b);
+  }
+};
+
+const ptrdiff_t radix_sort_threshold = 64;
+const size_t    radix_buckets = 256;
+
+template <bool Construct>
+struct radix_mover {
+  template <typename OutputIt, typename T>
+  static void
+  put(OutputIt d, T& value) {
+    *d = LIB::move(value);
+  }
+};
+
+template <>
+struct radix_mover<true> {
+  template <typename T>
+  static void
+  put(T* d, T& value) {
+    jnstl::Construct(d, LIB::move(value));
+  }
+};
+
+/* One stable LSD pass: distributes [first, last) on digit d into d_first.
+   offsets holds the exclusive prefix sums of the digit histogram. When
+   Construct is true d_first points to raw memory. */
+template <bool Construct, typename InputIt, typename OutputIt,
+          typename KeyOf>
+void
+radix_scatter(InputIt first, InputIt last, OutputIt d_first,
+              size_t* offsets, int d, const KeyOf& keyOf) {
+  typedef typename jnstl::iterator_traits<InputIt>::value_type value_type;
+  typedef jnstl::radix_key_of<value_type, KeyOf>               key_of;
+
+  for (; first != last; ++first) {
+    const size_t b = key_of::digit(keyOf, *first, d);
+    jnstl::radix_mover<Construct>::put(d_first + offsets[b]++, *first);
+  }
+}
+
+/* LSD radix sort through buffer, which holds room for last - first
+   elements. Only the digits on which the keys differ are processed, they
+   are listed in digits[0, numDigits) from the least significant one. */
+template <typename RandomIt, typename KeyOf>
+void
+radix_sort_lsd(RandomIt first, RandomIt last,
+               typename jnstl::iterator_traits<RandomIt>::value_type* buffer,
+               size_t (*counts)[radix_buckets], const int* digits,
+               int numDigits, const KeyOf& keyOf) {
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  const difference_type n = last - first;
+  bool inBuffer = false;
+
+  for (int i = 0; i < numDigits; ++i) {
+    const int d = digits[i];
+    size_t offsets[radix_buckets];
+    size_t sum = 0;
+
+    for (size_t b = 0; b < radix_buckets; ++b) {
+      offsets[b] = sum;
+      sum += counts[d][b];
+    }
+
+    if (inBuffer)
+      jnstl::radix_scatter<false>(buffer, buffer + n, first, offsets, d,
+                                  keyOf);
+    else if (i == 0)
+      jnstl::radix_scatter<true>(first, last, buffer, offsets, d, keyOf);
+    else
+      jnstl::radix_scatter<false>(first, last, buffer, offsets, d, keyOf);
+    inBuffer = !inBuffer;
+  }
+
+  if (inBuffer) {
+    RandomIt it = first;
+    for (difference_type i = 0; i < n; ++i, ++it)
+      *it = LIB::move(buffer[i]);
+  }
+  jnstl::Destruct(buffer, buffer + n);
+}
+
+/* In-place MSD radix sort (American flag sort) on digit d and below.
+   Elements are permuted into their buckets along cycles, then each bucket
+   is sorted on the next digit. Digits on which all the keys of a range
+   agree are skipped without moving anything. */
+template <typename RandomIt, typename KeyOf>
+void
+radix_sort_msd(RandomIt first, RandomIt last, int d, const KeyOf& keyOf) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+  typedef jnstl::radix_key_of<value_type, KeyOf>             key_of;
+
+  const difference_type n = last - first;
+
+  if (n < radix_sort_threshold) {
+    jnstl::sort(first, last, jnstl::radix_key_less<value_type, KeyOf>(keyOf));
+    return;
+  }
+
+  size_t counts[radix_buckets];
+
+  for (;;) {
+    memset(counts, 0, sizeof(counts));
+    for (RandomIt it = first; it != last; ++it)
+      ++counts[key_of::digit(keyOf, *it, d)];
+
+    if (counts[key_of::digit(keyOf, *first, d)] != size_t(n))
+      break;
+    if (d == 0)
+      return;
+    --d;
+  }
+
+  size_t heads[radix_buckets];
+  size_t tails[radix_buckets];
+  size_t sum = 0;
+
+  for (size_t b = 0; b < radix_buckets; ++b) {
+    heads[b] = sum;
+    sum += counts[b];
+    tails[b] = sum;
+  }
+
+  for (size_t b = 0; b < radix_buckets; ++b) {
+    while (heads[b] != tails[b]) {
+      value_type val(LIB::move(*(first + heads[b])));
+      size_t vb = key_of::digit(keyOf, val, d);
+
+      /* Follow the cycle until an element of bucket b comes back */
+      while (vb != b) {
+        LIB::swap(val, *(first + heads[vb]));
+        ++heads[vb];
+        vb = key_of::digit(keyOf, val, d);
+      }
+      *(first + heads[b]) = LIB::move(val);
+      ++heads[b];
+    }
+  }
+
+  if (d == 0)
+    return;
+
+  for (size_t b = 0; b < radix_buckets; ++b) {
+    if (counts[b] > 1)
+      jnstl::radix_sort_msd(first + (tails[b] - counts[b]), first + tails[b],
+                            d - 1, keyOf);
+  }
+}
+
+template <typename RandomIt, typename KeyOf>
+void
+radix_sort_impl(RandomIt first, RandomIt last, const KeyOf& keyOf) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+  typedef jnstl::radix_key_of<value_type, KeyOf>             key_of;
+  typedef typename key_of::key_type                          key_type;
+
+  const int kDigits = sizeof(key_type);
+  const difference_type n = last - first;
+
+  if (n < radix_sort_threshold) {
+    jnstl::sort(first, last, jnstl::radix_key_less<value_type, KeyOf>(keyOf));
+    return;
+  }
+
+  /* Histograms of every digit in a single pass */
+  size_t counts[kDigits][radix_buckets];
+  memset(counts, 0, sizeof(counts));
+
+  for (RandomIt it = first; it != last; ++it) {
+    const key_type key = key_of::get(keyOf, *it);
+    for (int d = 0; d < kDigits; ++d)
+      ++counts[d][(key >> (8 * d)) & 0xFF];
+  }
+
+  const key_type firstKey = key_of::get(keyOf, *first);
+  int digits[kDigits];
+  int numDigits = 0;
+
+  for (int d = 0; d < kDigits; ++d) {
+    if (counts[d][(firstKey >> (8 * d)) & 0xFF] != size_t(n))
+      digits[numDigits++] = d;
+  }
+
+  if (numDigits == 0)
+    return;
+
+  /* LSD makes one sequential pass per differing digit. MSD splits the range
+     into 256 buckets per level and stops once they are small, so it needs
+     about log256(n / radix_sort_threshold) permutation passes, which are
+     less cache friendly. LSD wins when it needs at most two more passes
+     than that, provided the scratch buffer can be had in full. */
+  int msdPasses = 1;
+  for (difference_type m = n / radix_sort_threshold; m > 256; m >>= 8)
+    ++msdPasses;
+
+  if (numDigits <= msdPasses + 2) {
+    jnstl::pair<value_type*, ptrdiff_t> buffer =
+        jnstl::get_temporary_buffer<value_type>(n);
+
+    if (buffer.second == n) {
+      jnstl::radix_sort_lsd(first, last, buffer.first, counts, digits,
+                            numDigits, keyOf);
+      jnstl::return_temporary_buffer(buffer.first);
+      return;
+    }
+    jnstl::return_temporary_buffer(buffer.first);
+  }
+
+  jnstl::radix_sort_msd(first, last, digits[numDigits - 1], keyOf);
+}
+
+}  // namespace jnstl
+
+#endif /* JNSTL_RADIX_SORT_H_ */
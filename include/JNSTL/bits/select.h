@@ -0,0 +1,171 @@
+#ifndef JNSTL_SELECT_H_
+#define JNSTL_SELECT_H_
+
+#include "JNSTL/bits/config.h"
+#include "JNSTL/bits/sort.h"
+#include "JNSTL/iterator.h"
+
+namespace jnstl {
+
+/* Groups of five elements are reduced to their median by a fixed network */
+const int select_group_size = 5;
+
+/* Puts the median of the five elements at first, first + 1, ... first + 4
+   in first + 2. */
+template <typename RandomIt, typename Compare>
+inline void
+select_median_of_five(RandomIt first, Compare comp) {
+  jnstl::sort2(first, first + 1, comp);
+  jnstl::sort2(first + 3, first + 4, comp);
+  /* Drop the smallest of the two minima, its own pair minimum is smaller
+     than three elements */
+  if (comp(*(first + 3), *first)) {
+    jnstl::iter_swap(first, first + 3);
+    jnstl::iter_swap(first + 1, first + 4);
+  }
+  /* first is out, the median is the second smallest of the other four */
+  jnstl::sort2(first + 1, first + 2, comp);
+  if (comp(*(first + 3), *(first + 1))) {
+    jnstl::iter_swap(first + 1, first + 3);
+    jnstl::iter_swap(first + 2, first + 4);
+  }
+  /* first + 1 is out, the median is the smallest of the remaining three */
+  if (comp(*(first + 3), *(first + 2)))
+    jnstl::iter_swap(first + 2, first + 3);
+}
+
+/* Median of medians selection: places in nth the element that would be
+   there if [first, last) was sorted, smaller elements before it and larger
+   ones after it, in guaranteed linear time. The pivot is the median of the
+   medians of groups of five, at least 3/10 of the range ends up on each
+   side of it. */
+template <typename RandomIt, typename Compare>
+void
+select_median_of_medians(RandomIt first, RandomIt nth, RandomIt last,
+                         Compare comp) {
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  while (last - first > S_threshold) {
+    const difference_type groups = (last - first) / select_group_size;
+
+    /* The medians are gathered at the front of the range, the elements
+       they displace go back in their group. Elements above a group median
+       stay in the range, providing the sentinel of unsafe_partition. */
+    for (difference_type i = 0; i < groups; ++i) {
+      const RandomIt group = first + i * select_group_size;
+      jnstl::select_median_of_five(group, comp);
+      jnstl::iter_swap(first + i, group + 2);
+    }
+
+    const RandomIt pivot = first + groups / 2;
+    jnstl::select_median_of_medians(first, pivot, first + groups, comp);
+
+    jnstl::iter_swap(first, pivot);
+    RandomIt cut = jnstl::unsafe_partition(first + 1, last, first, comp);
+
+    /* Put the pivot in its final position so that it can be excluded */
+    --cut;
+    jnstl::iter_swap(first, cut);
+
+    if (nth == cut)
+      return;
+    if (nth < cut)
+      last = cut;
+    else
+      first = cut + 1;
+  }
+  jnstl::insertion_sort(first, last, comp);
+}
+
+/* Quickselect on the median of three pivot of introsort. It gives up after
+   depth_limit partitions, as many as a balanced descent would need twice
+   over, and finishes with the median of medians. */
+template <typename RandomIt, typename Size, typename Compare>
+void
+introselect(RandomIt first, RandomIt nth, RandomIt last, Size depth_limit,
+            Compare comp) {
+  while (last - first > S_threshold) {
+    if (depth_limit == 0) {
+      jnstl::select_median_of_medians(first, nth, last, comp);
+      return;
+    }
+    --depth_limit;
+    RandomIt cut = jnstl::unsafe_partition_pivot(first, last, comp);
+    if (cut <= nth)
+      first = cut;
+    else
+      last = cut;
+  }
+  jnstl::insertion_sort(first, last, comp);
+}
+
+/* First position of [nthFirst, nthLast) not before pos */
+template <typename NthIt, typename RandomIt>
+inline NthIt
+select_split(NthIt nthFirst, NthIt nthLast, RandomIt pos) {
+  typedef typename
+      jnstl::iterator_traits<NthIt>::difference_type difference_type;
+
+  difference_type len = nthLast - nthFirst;
+
+  while (len > 0) {
+    const difference_type half = len / 2;
+    const NthIt mid = nthFirst + half;
+
+    if (*mid < pos) {
+      nthFirst = mid + 1;
+      len -= half + 1;
+    } else {
+      len = half;
+    }
+  }
+  return nthFirst;
+}
+
+/* introselect for all the positions in [nthFirst, nthLast), in ascending
+   order. Every partition hands the positions on each side to the
+   matching part, ranges without any position are left alone: O(n log k)
+   for k positions. Past depth_limit, the median of medians places the
+   middle position and both sides go on from there. */
+template <typename RandomIt, typename NthIt, typename Size, typename Compare>
+void
+multiselect_loop(RandomIt first, RandomIt last, NthIt nthFirst, NthIt nthLast,
+                 Size depth_limit, Compare comp) {
+  while (nthFirst != nthLast) {
+    if (last - first <= S_threshold) {
+      jnstl::insertion_sort(first, last, comp);
+      return;
+    }
+
+    if (nthLast - nthFirst == 1) {
+      jnstl::introselect(first, *nthFirst, last, depth_limit, comp);
+      return;
+    }
+
+    if (depth_limit == 0) {
+      const NthIt mid = nthFirst + (nthLast - nthFirst) / 2;
+      const RandomIt nth = *mid;
+
+      jnstl::select_median_of_medians(first, nth, last, comp);
+      jnstl::multiselect_loop(first, nth, nthFirst,
+                              jnstl::select_split(nthFirst, mid, nth),
+                              depth_limit, comp);
+      nthFirst = jnstl::select_split(mid, nthLast, nth + 1);
+      first = nth + 1;
+      continue;
+    }
+
+    --depth_limit;
+    const RandomIt cut = jnstl::unsafe_partition_pivot(first, last, comp);
+    const NthIt split = jnstl::select_split(nthFirst, nthLast, cut);
+
+    jnstl::multiselect_loop(first, cut, nthFirst, split, depth_limit, comp);
+    nthFirst = split;
+    first = cut;
+  }
+}
+
+}  // namespace jnstl
+
+#endif /* JNSTL_SELECT_H_ */
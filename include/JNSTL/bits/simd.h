@@ -0,0 +1,230 @@
+#ifndef JNSTL_SIMD_H_
+#define JNSTL_SIMD_H_
+
+#include <string.h>
+
+#include "JNSTL/bits/config.h"
+
+/* The kernels are built for SSE2 and AVX2 through target attributes, the
+   rest of the program keeps its own compiler flags and the variant is
+   picked at run time. Other targets and compilers use the scalar loops. */
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define JNSTL_SIMD_X86 1
+#include <immintrin.h>
+#define JNSTL_TARGET_SSE2 __attribute__((target("sse2")))
+#define JNSTL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define JNSTL_SIMD_X86 0
+#endif
+
+namespace jnstl {
+
+enum simd_level {
+  simd_scalar,
+  simd_sse2,
+  simd_avx2
+};
+
+inline simd_level
+simd_detect() {
+#if JNSTL_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return simd_avx2;
+  if (__builtin_cpu_supports("sse2"))
+    return simd_sse2;
+#endif
+  return simd_scalar;
+}
+
+/* Instruction set the kernels use, detected on first use */
+inline simd_level
+simd_current() {
+  static const simd_level sLevel = jnstl::simd_detect();
+  return sLevel;
+}
+
+/* Below this many bytes the kernels are not worth the dispatch */
+const size_t simd_min_bytes = 32;
+
+/* Fills bytes bytes at dst with the 16 byte block, repeated. bytes is a
+   multiple of the size of the element the block repeats, which divides 16:
+   the tail is a prefix of the block. */
+inline void
+simd_fill_scalar(unsigned char* dst, const unsigned char* block,
+                 size_t bytes) {
+  for (; bytes >= 16; bytes -= 16, dst += 16)
+    memcpy(dst, block, 16);
+  memcpy(dst, block, bytes);
+}
+
+/* Byte offset of the first difference between a and b, bytes if none */
+inline size_t
+simd_mismatch_scalar(const unsigned char* a, const unsigned char* b,
+                     size_t bytes) {
+  size_t i = 0;
+
+  for (; i < bytes; ++i) {
+    if (a[i] != b[i])
+      break;
+  }
+  return i;
+}
+
+#if JNSTL_SIMD_X86
+JNSTL_TARGET_SSE2 inline void
+simd_fill_sse2(unsigned char* dst, const unsigned char* block, size_t bytes) {
+  const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+
+  for (; bytes >= 64; bytes -= 64, dst += 64) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), v);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), v);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), v);
+  }
+  for (; bytes >= 16; bytes -= 16, dst += 16)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+  memcpy(dst, block, bytes);
+}
+
+JNSTL_TARGET_AVX2 inline void
+simd_fill_avx2(unsigned char* dst, const unsigned char* block, size_t bytes) {
+  const __m128i half =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+  const __m256i v = _mm256_broadcastsi128_si256(half);
+
+  for (; bytes >= 128; bytes -= 128, dst += 128) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), v);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 64), v);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 96), v);
+  }
+  for (; bytes >= 32; bytes -= 32, dst += 32)
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+  if (bytes >= 16) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), half);
+    bytes -= 16;
+    dst += 16;
+  }
+  memcpy(dst, block, bytes);
+}
+
+JNSTL_TARGET_SSE2 inline size_t
+simd_mismatch_sse2(const unsigned char* a, const unsigned char* b,
+                   size_t bytes) {
+  size_t i = 0;
+
+  for (; i + 16 <= bytes; i += 16) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    const unsigned mask =
+        static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+
+    if (mask != 0xFFFF)
+      return i + __builtin_ctz(~mask);
+  }
+  return i + jnstl::simd_mismatch_scalar(a + i, b + i, bytes - i);
+}
+
+/* Four vectors per iteration, their comparisons are combined so that the
+   loop only branches once per 128 bytes. */
+JNSTL_TARGET_AVX2 inline size_t
+simd_mismatch_avx2(const unsigned char* a, const unsigned char* b,
+                   size_t bytes) {
+  size_t i = 0;
+
+  for (; i + 128 <= bytes; i += 128) {
+    const __m256i* x = reinterpret_cast<const __m256i*>(a + i);
+    const __m256i* y = reinterpret_cast<const __m256i*>(b + i);
+    const __m256i eq01 = _mm256_and_si256(
+        _mm256_cmpeq_epi8(_mm256_loadu_si256(x), _mm256_loadu_si256(y)),
+        _mm256_cmpeq_epi8(_mm256_loadu_si256(x + 1),
+                          _mm256_loadu_si256(y + 1)));
+    const __m256i eq23 = _mm256_and_si256(
+        _mm256_cmpeq_epi8(_mm256_loadu_si256(x + 2),
+                          _mm256_loadu_si256(y + 2)),
+        _mm256_cmpeq_epi8(_mm256_loadu_si256(x + 3),
+                          _mm256_loadu_si256(y + 3)));
+
+    if (static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(eq01, eq23))) != 0xFFFFFFFFu)
+      break;
+  }
+  for (; i + 32 <= bytes; i += 32) {
+    const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)))));
+
+    if (mask != 0xFFFFFFFFu)
+      return i + __builtin_ctz(~mask);
+  }
+  return i + jnstl::simd_mismatch_scalar(a + i, b + i, bytes - i);
+}
+#endif
+
+inline void
+simd_fill(unsigned char* dst, const unsigned char* block, size_t bytes) {
+#if JNSTL_SIMD_X86
+  if (bytes >= simd_min_bytes) {
+    switch (jnstl::simd_current()) {
+      case simd_avx2:
+        jnstl::simd_fill_avx2(dst, block, bytes);
+        return;
+      case simd_sse2:
+        jnstl::simd_fill_sse2(dst, block, bytes);
+        return;
+      default:
+        break;
+    }
+  }
+#endif
+  jnstl::simd_fill_scalar(dst, block, bytes);
+}
+
+inline size_t
+simd_mismatch(const unsigned char* a, const unsigned char* b, size_t bytes) {
+#if JNSTL_SIMD_X86
+  if (bytes >= simd_min_bytes) {
+    switch (jnstl::simd_current()) {
+      case simd_avx2:
+        return jnstl::simd_mismatch_avx2(a, b, bytes);
+      case simd_sse2:
+        return jnstl::simd_mismatch_sse2(a, b, bytes);
+      default:
+        break;
+    }
+  }
+#endif
+  return jnstl::simd_mismatch_scalar(a, b, bytes);
+}
+
+/* Fills [first, first + n) with value, T being trivially copyable and of
+   a size dividing 16. */
+template <typename T>
+inline void
+simd_fill_n(T* first, size_t n, const T& value) {
+  static_assert(16 % sizeof(T) == 0, "element size must divide 16");
+
+  unsigned char block[16];
+
+  for (size_t i = 0; i < 16; i += sizeof(T))
+    memcpy(block + i, &value, sizeof(T));
+  jnstl::simd_fill(reinterpret_cast<unsigned char*>(first), block,
+                   n * sizeof(T));
+}
+
+/* Index of the first element of [a, a + n) different from the one of
+   [b, b + n), T being compared by its bytes. */
+template <typename T>
+inline size_t
+simd_mismatch_n(const T* a, const T* b, size_t n) {
+  return jnstl::simd_mismatch(reinterpret_cast<const unsigned char*>(a),
+                              reinterpret_cast<const unsigned char*>(b),
+                              n * sizeof(T)) / sizeof(T);
+}
+
+}  // namespace jnstl
+
+#endif /* JNSTL_SIMD_H_ */
@@ -1,15 +1,13 @@
 #ifndef JNSTL_SORT_H_
 #define JNSTL_SORT_H_
 
+#include <functional>
+#include <type_traits>
+
 #include "JNSTL/bits/config.h"
+#include "JNSTL/utility.h"
 
 namespace jnstl {
-template <typename InputIt1, typename InputIt2,
-          typename OutputIt, typename Compare>
-OutputIt
-merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
-      OutputIt d_first, Compare comp);
-
 template <typename ForwardIt1, typename ForwardIt2>
 void
 iter_swap(ForwardIt1 a, ForwardIt2 b);
@@ -42,45 +40,6 @@ move_median_to_first(Iter first, Iter a, Iter b, Iter c, Compare comp) {
   }
 }
 
-template <typename RandomIt, typename Pointer, typename Compare>
-void
-merge_sort_buffer(RandomIt first, RandomIt last, Pointer buffer, Compare comp) {
-  typedef typename iterator_traits<RandomIt>::difference_type  difference_type;
-
-  const difference_type count = last -first;
-
-  if (count > 1) {
-    const difference_type mid = count / 2;
-    const RandomIt middle = first + mid;
-
-    /* split one more time at this level to reduce recursive depth */
-    if (mid > 1) {
-      const difference_type q1 = mid / 2;
-      const RandomIt part(first + q1);
-
-      jnstl::merge_sort_buffer(first, part, buffer, comp);
-      jnstl::merge_sort_buffer(part, middle, buffer + q1, comp);
-      jnstl::merge(first, part, part, middle, buffer, comp);
-    } else {
-      *buffer = *first;
-    }
-
-    if (count - mid > 1) {
-      const difference_type q3 = mid + (count - mid) / 2;
-      const RandomIt part(first + q3);
-
-      jnstl::merge_sort_buffer(middle, part, buffer + mid, comp);
-      jnstl::merge_sort_buffer(part, last, buffer + q3, comp);
-      jnstl::merge(middle, part, part, last, buffer + mid, comp);
-    } else {
-      *(buffer + mid) = *middle;
-    }
-
-    jnstl::merge(buffer, buffer + mid, buffer + mid, buffer + count,
-                 first, comp);
-  }
-}
-
 template <typename RandomIt, typename Compare>
 inline void
 unsafe_linear_insert(RandomIt last, Compare comp) {
@@ -208,6 +167,441 @@ introsort_loop(RandomIt first, RandomIt last, Size depth_limit, Compare comp) {
   }
 }
 
+/* Pattern-defeating quicksort (pdqsort), used by jnstl::sort.
+   On top of the introsort scheme above it:
+   - picks the pivot as the median of three, or the pseudo median of nine
+     (ninther) for ranges larger than pdq_ninther_threshold,
+   - detects partitions that did not swap anything and tries to finish them
+     with a bounded insertion sort, so sorted and reversed inputs run in
+     linear time,
+   - puts the elements equal to the pivot in their own partition when the
+     pivot equals the one of the parent partition, so ranges with many
+     duplicates run in O(n log k) for k distinct values,
+   - shuffles a few elements after a highly unbalanced partition to break
+     patterns defeating the pivot selection, and falls back to heapsort
+     after log2(n) of them, keeping the O(n log n) worst case. */
+const int pdq_insertion_threshold = 24;
+const int pdq_ninther_threshold = 128;
+const int pdq_partial_insertion_limit = 8;
+
+template <typename Size>
+inline int
+sort_log2(Size n) {
+  int log = 0;
+  while (n >>= 1)
+    ++log;
+  return log;
+}
+
+template <typename Iter, typename Compare>
+inline void
+sort2(Iter a, Iter b, Compare comp) {
+  if (comp(*b, *a))
+    jnstl::iter_swap(a, b);
+}
+
+/* Sorts *a, *b and *c, the median ends up in b */
+template <typename Iter, typename Compare>
+inline void
+sort3(Iter a, Iter b, Iter c, Compare comp) {
+  jnstl::sort2(a, b, comp);
+  jnstl::sort2(b, c, comp);
+  jnstl::sort2(a, b, comp);
+}
+
+/* Insertion sort giving up once more than pdq_partial_insertion_limit
+   elements have been moved. Returns true if the range got sorted. */
+template <typename RandomIt, typename Compare>
+inline bool
+partial_insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  if (first == last)
+    return true;
+
+  difference_type moved = 0;
+  for (RandomIt cur = first + 1; cur != last; ++cur) {
+    RandomIt sift = cur;
+    RandomIt sift_1 = cur - 1;
+
+    if (comp(*sift, *sift_1)) {
+      value_type val(LIB::move(*sift));
+
+      do {
+        *sift = LIB::move(*sift_1);
+        --sift;
+      } while (sift != first && comp(val, *--sift_1));
+      *sift = LIB::move(val);
+      moved += cur - sift;
+    }
+    if (moved > pdq_partial_insertion_limit)
+      return false;
+  }
+  return true;
+}
+
+/* Partitions [first, last) around the pivot *first into the elements less
+   than the pivot and the elements greater or equal. Returns the final
+   position of the pivot and whether the range was already partitioned.
+   The pivot selection guarantees an element >= pivot in the range, which
+   stops the first scan, the second one is guarded on its first run only. */
+template <typename RandomIt, typename Compare>
+inline jnstl::pair<RandomIt, bool>
+pdq_partition_right(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+  value_type pivot(LIB::move(*first));
+  RandomIt lo = first;
+  RandomIt hi = last;
+
+  while (comp(*++lo, pivot)) {}
+
+  if (lo - 1 == first) {
+    while (lo < hi && !comp(*--hi, pivot)) {}
+  } else {
+    while (!comp(*--hi, pivot)) {}
+  }
+
+  const bool already_partitioned = !(lo < hi);
+
+  while (lo < hi) {
+    jnstl::iter_swap(lo, hi);
+    while (comp(*++lo, pivot)) {}
+    while (!comp(*--hi, pivot)) {}
+  }
+
+  RandomIt pivot_pos = lo - 1;
+  *first = LIB::move(*pivot_pos);
+  *pivot_pos = LIB::move(pivot);
+
+  return jnstl::pair<RandomIt, bool>(pivot_pos, already_partitioned);
+}
+
+/* Comparisons that compile to a single branch-free instruction: arithmetic
+   keys ordered by std::less or std::greater. For those the partition uses
+   pdq_partition_right_block. */
+template <typename T, typename Compare>
+struct is_block_partitionable
+    : public std::integral_constant<
+          bool,
+          std::is_arithmetic<T>::value &&
+          (std::is_same<Compare, std::less<T> >::value ||
+           std::is_same<Compare, std::greater<T> >::value ||
+           std::is_same<Compare, std::less<> >::value ||
+           std::is_same<Compare, std::greater<> >::value)> {};
+
+const size_t pdq_block_size = 64;
+
+/* Swaps the num elements at first + offsets_l[i] with the ones at
+   last - offsets_r[i]. When the two blocks do not have the same number of
+   misplaced elements a cyclic permutation is used, it needs one move per
+   element instead of the three of a swap. */
+template <typename RandomIt>
+inline void
+pdq_swap_offsets(RandomIt first, RandomIt last,
+                 const unsigned char* offsets_l,
+                 const unsigned char* offsets_r,
+                 size_t num, bool use_swaps) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+  if (use_swaps) {
+    for (size_t i = 0; i < num; ++i)
+      jnstl::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+  } else if (num > 0) {
+    RandomIt l = first + offsets_l[0];
+    RandomIt r = last - offsets_r[0];
+    value_type tmp(LIB::move(*l));
+
+    *l = LIB::move(*r);
+    for (size_t i = 1; i < num; ++i) {
+      l = first + offsets_l[i];
+      *r = LIB::move(*l);
+      r = last - offsets_r[i];
+      *l = LIB::move(*r);
+    }
+    *r = LIB::move(tmp);
+  }
+}
+
+/* Same contract as pdq_partition_right, with the block partitioning of
+   Edelkamp and Weiss (BlockQuicksort). Blocks of pdq_block_size elements
+   are scanned from both ends, the offsets of the misplaced elements are
+   recorded without branching on the comparison result (the offset is
+   always stored, the count only advances when the element is misplaced),
+   then the misplaced elements are swapped in batches. This avoids the
+   branch mispredictions of the scanning loops on random input. */
+template <typename RandomIt, typename Compare>
+inline jnstl::pair<RandomIt, bool>
+pdq_partition_right_block(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+  value_type pivot(LIB::move(*first));
+  RandomIt lo = first;
+  RandomIt hi = last;
+
+  while (comp(*++lo, pivot)) {}
+
+  if (lo - 1 == first) {
+    while (lo < hi && !comp(*--hi, pivot)) {}
+  } else {
+    while (!comp(*--hi, pivot)) {}
+  }
+
+  const bool already_partitioned = !(lo < hi);
+
+  if (!already_partitioned) {
+    jnstl::iter_swap(lo, hi);
+    ++lo;
+
+    alignas(64) unsigned char offsets_l[pdq_block_size];
+    alignas(64) unsigned char offsets_r[pdq_block_size];
+    RandomIt offsets_l_base = lo;
+    RandomIt offsets_r_base = hi;
+    size_t num_l = 0;
+    size_t num_r = 0;
+    size_t start_l = 0;
+    size_t start_r = 0;
+
+    while (lo < hi) {
+      /* Only refill the blocks that have been emptied, splitting what is
+         left evenly when both are. */
+      const size_t num_unknown = hi - lo;
+      const size_t left_split =
+          num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+      const size_t right_split = num_r == 0 ? num_unknown - left_split : 0;
+
+      if (left_split >= pdq_block_size) {
+        for (size_t i = 0; i < pdq_block_size; i += 4) {
+          offsets_l[num_l] = i;     num_l += !comp(*lo, pivot); ++lo;
+          offsets_l[num_l] = i + 1; num_l += !comp(*lo, pivot); ++lo;
+          offsets_l[num_l] = i + 2; num_l += !comp(*lo, pivot); ++lo;
+          offsets_l[num_l] = i + 3; num_l += !comp(*lo, pivot); ++lo;
+        }
+      } else {
+        for (size_t i = 0; i < left_split; ++i) {
+          offsets_l[num_l] = i;
+          num_l += !comp(*lo, pivot);
+          ++lo;
+        }
+      }
+
+      if (right_split >= pdq_block_size) {
+        for (size_t i = 0; i < pdq_block_size; i += 4) {
+          offsets_r[num_r] = i + 1; num_r += comp(*--hi, pivot);
+          offsets_r[num_r] = i + 2; num_r += comp(*--hi, pivot);
+          offsets_r[num_r] = i + 3; num_r += comp(*--hi, pivot);
+          offsets_r[num_r] = i + 4; num_r += comp(*--hi, pivot);
+        }
+      } else {
+        for (size_t i = 0; i < right_split; ++i) {
+          offsets_r[num_r] = i + 1;
+          num_r += comp(*--hi, pivot);
+        }
+      }
+
+      const size_t num = num_l < num_r ? num_l : num_r;
+      jnstl::pdq_swap_offsets(offsets_l_base, offsets_r_base,
+                              offsets_l + start_l, offsets_r + start_r,
+                              num, num_l == num_r);
+      num_l -= num;
+      num_r -= num;
+      start_l += num;
+      start_r += num;
+
+      if (num_l == 0) {
+        start_l = 0;
+        offsets_l_base = lo;
+      }
+      if (num_r == 0) {
+        start_r = 0;
+        offsets_r_base = hi;
+      }
+    }
+
+    /* One of the blocks still has misplaced elements, move them next to
+       the boundary. */
+    if (num_l) {
+      while (num_l--)
+        jnstl::iter_swap(offsets_l_base + offsets_l[start_l + num_l], --hi);
+      lo = hi;
+    }
+    if (num_r) {
+      while (num_r--) {
+        jnstl::iter_swap(offsets_r_base - offsets_r[start_r + num_r], lo);
+        ++lo;
+      }
+    }
+  }
+
+  RandomIt pivot_pos = lo - 1;
+  *first = LIB::move(*pivot_pos);
+  *pivot_pos = LIB::move(pivot);
+
+  return jnstl::pair<RandomIt, bool>(pivot_pos, already_partitioned);
+}
+
+template <bool Block>
+struct pdq_partitioner {
+  template <typename RandomIt, typename Compare>
+  static jnstl::pair<RandomIt, bool>
+  partition_right(RandomIt first, RandomIt last, Compare comp) {
+    return jnstl::pdq_partition_right(first, last, comp);
+  }
+};
+
+template <>
+struct pdq_partitioner<true> {
+  template <typename RandomIt, typename Compare>
+  static jnstl::pair<RandomIt, bool>
+  partition_right(RandomIt first, RandomIt last, Compare comp) {
+    return jnstl::pdq_partition_right_block(first, last, comp);
+  }
+};
+
+/* Mirror of pdq_partition_right putting the elements equal to the pivot on
+   the left. Only used when the element before first equals the pivot, in
+   which case no element of [first, last) is less than the pivot and the
+   whole left side is made of elements equal to it. */
+template <typename RandomIt, typename Compare>
+inline RandomIt
+pdq_partition_left(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+  value_type pivot(LIB::move(*first));
+  RandomIt lo = first;
+  RandomIt hi = last;
+
+  while (comp(pivot, *--hi)) {}
+
+  if (hi + 1 == last) {
+    while (lo < hi && !comp(pivot, *++lo)) {}
+  } else {
+    while (!comp(pivot, *++lo)) {}
+  }
+
+  while (lo < hi) {
+    jnstl::iter_swap(lo, hi);
+    while (comp(pivot, *--hi)) {}
+    while (!comp(pivot, *++lo)) {}
+  }
+
+  *first = LIB::move(*hi);
+  *hi = LIB::move(pivot);
+
+  return hi;
+}
+
+/* Moves the pivot to first: median of three for small ranges, ninther for
+   larger ones. Both leave an element <= pivot and an element >= pivot
+   in the range, the sentinels of the partition scans. */
+template <typename RandomIt, typename Compare>
+inline void
+pdq_choose_pivot(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  const difference_type size = last - first;
+  const difference_type s2 = size / 2;
+
+  if (size > pdq_ninther_threshold) {
+    jnstl::sort3(first, first + s2, last - 1, comp);
+    jnstl::sort3(first + 1, first + (s2 - 1), last - 2, comp);
+    jnstl::sort3(first + 2, first + (s2 + 1), last - 3, comp);
+    jnstl::sort3(first + (s2 - 1), first + s2, first + (s2 + 1), comp);
+    jnstl::iter_swap(first, first + s2);
+  } else {
+    jnstl::sort3(first + s2, first, last - 1, comp);
+  }
+}
+
+/* Swaps a few elements of a partition of size elements starting at first
+   (and ending at last) with elements a quarter further in. */
+template <typename RandomIt, typename Size>
+inline void
+pdq_break_patterns(RandomIt first, RandomIt last, Size size) {
+  if (size < pdq_insertion_threshold)
+    return;
+
+  jnstl::iter_swap(first, first + size / 4);
+  jnstl::iter_swap(last - 1, last - size / 4);
+
+  if (size > pdq_ninther_threshold) {
+    jnstl::iter_swap(first + 1, first + (size / 4 + 1));
+    jnstl::iter_swap(first + 2, first + (size / 4 + 2));
+    jnstl::iter_swap(last - 2, last - (size / 4 + 1));
+    jnstl::iter_swap(last - 3, last - (size / 4 + 2));
+  }
+}
+
+/* leftmost is false when the element before first is a sentinel, i.e. not
+   greater than any element of [first, last). */
+template <bool Block, typename RandomIt, typename Compare>
+void
+pdqsort_loop(RandomIt first, RandomIt last, Compare comp, int bad_allowed,
+             bool leftmost) {
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  while (true) {
+    const difference_type size = last - first;
+
+    if (size < pdq_insertion_threshold) {
+      if (leftmost)
+        jnstl::insertion_sort(first, last, comp);
+      else
+        jnstl::unsafe_insertion_sort(first, last, comp);
+      return;
+    }
+
+    jnstl::pdq_choose_pivot(first, last, comp);
+
+    /* The pivot equals the one of the parent partition: every element of
+       the range is >= pivot, group the ones equal to it and skip them. */
+    if (!leftmost && !comp(*(first - 1), *first)) {
+      first = jnstl::pdq_partition_left(first, last, comp) + 1;
+      continue;
+    }
+
+    const jnstl::pair<RandomIt, bool> part =
+        jnstl::pdq_partitioner<Block>::partition_right(first, last, comp);
+    const RandomIt pivot_pos = part.first;
+    const difference_type l_size = pivot_pos - first;
+    const difference_type r_size = last - (pivot_pos + 1);
+
+    if (l_size < size / 8 || r_size < size / 8) {
+      if (--bad_allowed == 0) {
+        jnstl::partial_sort_impl(first, last, last, comp);
+        return;
+      }
+      jnstl::pdq_break_patterns(first, pivot_pos, l_size);
+      jnstl::pdq_break_patterns(pivot_pos + 1, last, r_size);
+    } else if (part.second &&
+               jnstl::partial_insertion_sort(first, pivot_pos, comp) &&
+               jnstl::partial_insertion_sort(pivot_pos + 1, last, comp)) {
+      return;
+    }
+
+    /* Recurse on the left side, loop on the right one */
+    jnstl::pdqsort_loop<Block>(first, pivot_pos, comp, bad_allowed,
+                               leftmost);
+    first = pivot_pos + 1;
+    leftmost = false;
+  }
+}
+
+template <typename RandomIt, typename Compare>
+inline void
+pdqsort(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+  if (last - first > 1)
+    jnstl::pdqsort_loop<
+        jnstl::is_block_partitionable<value_type, Compare>::value>(
+            first, last, comp, jnstl::sort_log2(last - first), true);
+}
+
 }  // namespace jnstl
 
 #endif /* JNSTL_SORT_H_ */
@@ -0,0 +1,177 @@
+#ifndef JNSTL_TOPK_H_
+#define JNSTL_TOPK_H_
+
+#include <type_traits>
+
+#include "JNSTL/bits/config.h"
+#include "JNSTL/bits/heap.h"
+#include "JNSTL/bits/select.h"
+#include "JNSTL/bits/sort.h"
+#include "JNSTL/iterator.h"
+
+namespace jnstl {
+
+template <typename RandomIt, typename Compare>
+void
+sort_heap(RandomIt first, RandomIt last, Compare comp);
+
+/* Top-k selection behind partial_sort and partial_sort_copy. The k
+   smallest elements seen so far are kept either in a sorted buffer, for k
+   up to topk_insertion_threshold where shifting a few elements beats the
+   sifts of a heap, or in a max heap. Either way the largest kept element is
+   the threshold a candidate has to beat, which after the first few
+   thousand elements is rarely the case. When k is a sizeable fraction of
+   the range, selecting the k-th element first and sorting what is before
+   it is cheaper than going through the heap. */
+const ptrdiff_t topk_insertion_threshold = 16;
+const ptrdiff_t topk_select_ratio = 64;
+
+/* Elements compared at once against the threshold by the filter */
+const ptrdiff_t topk_filter_block = 32;
+
+/* Inserts val in the sorted range [first, back], dropping the element at
+   back. */
+template <typename RandomIt, typename T, typename Compare>
+inline void
+topk_insert_sorted(RandomIt first, RandomIt back, T val, Compare comp) {
+  while (back != first && comp(val, *(back - 1))) {
+    *back = LIB::move(*(back - 1));
+    --back;
+  }
+  *back = LIB::move(val);
+}
+
+/* Runs insert on the elements of [first, last) comparing less than the
+   one at threshold, which insert may change. */
+template <bool Filter>
+struct topk_scanner {
+  template <typename RandomIt, typename Compare, typename Insert>
+  static void
+  scan(RandomIt first, RandomIt last, RandomIt threshold, Compare comp,
+       Insert insert) {
+    for (; first != last; ++first) {
+      if (comp(*first, *threshold))
+        insert(first);
+    }
+  }
+};
+
+/* Arithmetic elements under std::less or std::greater: blocks are first
+   tested with a branchless reduction over a copy of the threshold, which
+   the compiler turns into vector compares, and only gone through one by
+   one when one of their elements qualifies. */
+template <>
+struct topk_scanner<true> {
+  template <typename RandomIt, typename Compare, typename Insert>
+  static void
+  scan(RandomIt first, RandomIt last, RandomIt threshold, Compare comp,
+       Insert insert) {
+    typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+    while (last - first >= topk_filter_block) {
+      const value_type bound = *threshold;
+      unsigned any = 0;
+
+      for (ptrdiff_t i = 0; i < topk_filter_block; ++i)
+        any |= comp(first[i], bound);
+
+      if (any) {
+        const RandomIt blockEnd = first + topk_filter_block;
+        topk_scanner<false>::scan(first, blockEnd, threshold, comp, insert);
+        first = blockEnd;
+      } else {
+        first += topk_filter_block;
+      }
+    }
+    topk_scanner<false>::scan(first, last, threshold, comp, insert);
+  }
+};
+
+template <typename RandomIt, typename Compare>
+void
+topk_partial_sort(RandomIt first, RandomIt middle, RandomIt last,
+                  Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+  typedef jnstl::topk_scanner<
+      jnstl::is_block_partitionable<value_type, Compare>::value> scanner;
+
+  const difference_type k = middle - first;
+  const difference_type n = last - first;
+
+  if (k == 0)
+    return;
+
+  if (k > topk_insertion_threshold && k >= n / topk_select_ratio) {
+    jnstl::introselect(first, middle - 1, last, 2 * jnstl::sort_log2(n),
+                       comp);
+    jnstl::pdqsort(first, middle - 1, comp);
+    return;
+  }
+
+  if (k <= topk_insertion_threshold) {
+    const RandomIt back = middle - 1;
+
+    jnstl::insertion_sort(first, middle, comp);
+    scanner::scan(middle, last, back, comp, [&](RandomIt it) {
+      value_type val(LIB::move(*it));
+      *it = LIB::move(*back);
+      jnstl::topk_insert_sorted(first, back, LIB::move(val), comp);
+    });
+    return;
+  }
+
+  jnstl::make_heap_impl(first, middle, comp);
+  scanner::scan(middle, last, first, comp, [&](RandomIt it) {
+    jnstl::pop_heap_impl(first, middle, it, comp);
+  });
+  jnstl::sort_heap(first, middle, comp);
+}
+
+/* partial_sort_copy: the destination is filled from the input, then
+   serves as the sorted buffer or heap the remaining input goes through. */
+template <typename InputIt, typename RandomIt, typename Compare>
+RandomIt
+topk_partial_sort_copy(InputIt first, InputIt last, RandomIt d_first,
+                       RandomIt d_last, Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  RandomIt d_end = d_first;
+
+  for (; first != last && d_end != d_last; ++first, ++d_end)
+    *d_end = *first;
+
+  const difference_type k = d_end - d_first;
+
+  if (first == last || k == 0) {
+    jnstl::pdqsort(d_first, d_end, comp);
+    return d_end;
+  }
+
+  if (k <= topk_insertion_threshold) {
+    const RandomIt back = d_end - 1;
+
+    jnstl::insertion_sort(d_first, d_end, comp);
+    for (; first != last; ++first) {
+      if (comp(*first, *back))
+        jnstl::topk_insert_sorted(d_first, back, value_type(*first), comp);
+    }
+    return d_end;
+  }
+
+  jnstl::make_heap_impl(d_first, d_end, comp);
+  for (; first != last; ++first) {
+    if (comp(*first, *d_first))
+      jnstl::adjust_heap(d_first, difference_type(0), k, value_type(*first),
+                         comp);
+  }
+  jnstl::sort_heap(d_first, d_end, comp);
+  return d_end;
+}
+
+}  // namespace jnstl
+
+#endif /* JNSTL_TOPK_H_ */
@@ -0,0 +1,947 @@
+#ifndef JNSTL_DEQUE_H_
+#define JNSTL_DEQUE_H_
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <initializer_list>
+
+#include "JNSTL/bits/config.h"
+#include "JNSTL/bits/construct.h"
+
+#include "JNSTL/algorithm.h"
+#include "JNSTL/allocator.h"
+#include "JNSTL/iterator.h"
+#include "JNSTL/memory.h"
+#include "JNSTL/type_traits.h"
+
+namespace jnstl {
+
+/* Iterators hold the position of their element counted from the start of
+   the buffer without wrapping around, begin() at the head and end() size()
+   elements after it. Positions compare and subtract as plain indices and
+   are only reduced by the mask when dereferenced. */
+template <typename T, typename Pointer, typename Reference>
+struct DequeIterator {
+  typedef DequeIterator<T, Pointer, Reference>   this_type;
+
+  typedef size_t                                 size_type;
+  typedef ptrdiff_t                              difference_type;
+  typedef T                                      value_type;
+  typedef Pointer                                pointer;
+  typedef Reference                              reference;
+  typedef jnstl::random_access_iterator_tag      iterator_category;
+
+ public:
+  T*        mData;
+  size_type mMask;
+  size_type mIndex;
+
+  DequeIterator()
+      : mData(nullptr),
+        mMask(0),
+        mIndex(0) {}
+
+  DequeIterator(const T* pData, size_type mask, size_type index)
+      : mData(const_cast<T*>(pData)),
+        mMask(mask),
+        mIndex(index) {}
+
+  /* iterator to const_iterator, iterator itself keeps its implicit copy
+     constructor and assignment */
+  template <typename P, typename R, typename = typename std::enable_if<
+      std::is_same<P, T*>::value && !std::is_same<Pointer, T*>::value>::type>
+  DequeIterator(const DequeIterator<T, P, R>& x)
+      : mData(x.mData),
+        mMask(x.mMask),
+        mIndex(x.mIndex) {}
+
+  reference operator*() const {
+    return mData[mIndex & mMask];
+  }
+  pointer   operator->() const {
+    return mData + (mIndex & mMask);
+  }
+  reference operator[](difference_type n) const {
+    return mData[(mIndex + n) & mMask];
+  }
+
+  this_type& operator++() {
+    ++mIndex;
+    return *this;
+  }
+  this_type  operator++(int) {
+    this_type temp(*this);
+    ++mIndex;
+    return temp;
+  }
+
+  this_type& operator--() {
+    --mIndex;
+    return *this;
+  }
+  this_type  operator--(int) {
+    this_type temp(*this);
+    --mIndex;
+    return temp;
+  }
+
+  this_type& operator+=(difference_type n) {
+    mIndex += n;
+    return *this;
+  }
+  this_type& operator-=(difference_type n) {
+    mIndex -= n;
+    return *this;
+  }
+
+  this_type operator+(difference_type n) const {
+    return this_type(mData, mMask, mIndex + n);
+  }
+  this_type operator-(difference_type n) const {
+    return this_type(mData, mMask, mIndex - n);
+  }
+};
+
+template <typename T, typename Allocator>
+class DequeBase {
+ public:
+  typedef T           value_type;
+  typedef Allocator   allocator_type;
+  typedef size_t      size_type;
+  typedef ptrdiff_t   difference_type;
+
+ protected:
+  T*             mData;
+  size_type      mCapacity;  // zero or a power of two
+  size_type      mHead;
+  size_type      mSize;
+  allocator_type mAllocator;
+
+ public:
+  DequeBase();
+  explicit DequeBase(const allocator_type& allocator);
+
+  ~DequeBase();
+
+ protected:
+  T*   DoAllocate(size_type n);
+  void DoFree(T* p, size_type n);
+  void DoDestructAll();
+};
+
+/**
+ * @brief A double-ended queue stored in a single ring buffer.
+ *
+ * The elements live in one contiguous buffer whose capacity is a power of
+ * two, from the head slot onwards and wrapping around to the start of the
+ * buffer. Pushing or popping at either end is a masked index update, the
+ * buffer doubles when full and the elements are then moved to the start
+ * of the new one. As with std::deque, pushing invalidates every iterator;
+ * references to the elements stay valid unless the buffer grows, or is
+ * shrunk by shrink_to_fit().
+ */
+template <typename T, typename Allocator = jnstl::allocator>
+class deque : private DequeBase<T, Allocator> {
+  typedef DequeBase<T, Allocator>                 base_type;
+  typedef deque<T, Allocator>                     this_type;
+
+ public:
+  typedef T                                       value_type;
+  typedef T*                                      pointer;
+  typedef const T*                                const_pointer;
+  typedef T&                                      reference;
+  typedef const T&                                const_reference;
+  typedef DequeIterator<T, T*, T&>                iterator;
+  typedef DequeIterator<T, const T*, const T&>    const_iterator;
+  typedef jnstl::reverse_iterator<iterator>       reverse_iterator;
+  typedef jnstl::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef typename base_type::size_type           size_type;
+  typedef typename base_type::difference_type     difference_type;
+  typedef typename base_type::allocator_type      allocator_type;
+
+  using base_type::mData;
+  using base_type::mCapacity;
+  using base_type::mHead;
+  using base_type::mSize;
+  using base_type::mAllocator;
+  using base_type::DoAllocate;
+  using base_type::DoFree;
+  using base_type::DoDestructAll;
+
+  deque();
+  explicit deque(const allocator_type& allocator);
+  explicit deque(size_type n,
+                 const allocator_type& allocator = allocator_type{});
+  deque(size_type n, const value_type& value,
+        const allocator_type& allocator = allocator_type{});
+
+  template <typename InputIterator>
+  deque(InputIterator first, InputIterator last,
+        const allocator_type& allocator = allocator_type{});
+
+  deque(std::initializer_list<value_type> ilist,
+        const allocator_type& allocator = allocator_type{});
+
+  deque(const this_type& rhs);
+  deque(const this_type& rhs, const allocator_type& allocator);
+  deque(this_type&& rhs);
+  deque(this_type&& rhs, const allocator_type& allocator);
+
+  this_type& operator=(const this_type& rhs);
+  this_type& operator=(this_type&& rhs);
+
+  void swap(this_type& rhs);
+
+        reference operator[](size_type i);
+  const_reference operator[](size_type i) const;
+
+        reference at(size_type i);
+  const_reference at(size_type i) const;
+
+  iterator       begin();
+  const_iterator begin() const;
+
+  iterator       end();
+  const_iterator end() const;
+
+  reverse_iterator       rbegin();
+  const_reverse_iterator rbegin() const;
+
+  reverse_iterator       rend();
+  const_reverse_iterator rend() const;
+
+  bool      empty() const;
+  size_type size() const;
+  size_type capacity() const;
+
+  void resize(size_type n, const value_type& value = value_type{});
+  void reserve(size_type n);
+  void shrink_to_fit();
+
+  reference       front();
+  const_reference front() const;
+
+  reference       back();
+  const_reference back() const;
+
+  void push_front(const value_type&  value);
+  void push_front(      value_type&& value);
+
+  void push_back(const value_type&  value);
+  void push_back(      value_type&& value);
+
+  void pop_front();
+  void pop_back();
+
+  template <typename... Args>
+  reference emplace_front(Args&&... args);
+  template <typename... Args>
+  reference emplace_back(Args&&... args);
+
+  void clear();
+
+  bool validate() const;
+
+ protected:
+  template <typename Integer>
+  void DoInit(Integer n, Integer value, std::true_type);
+
+  template <typename InputIterator>
+  void DoInit(InputIterator first, InputIterator last, std::false_type);
+
+  template <typename InputIterator>
+  void DoInitFromIterator(InputIterator first, InputIterator last,
+                          jnstl::input_iterator_tag);
+
+  template <typename ForwardIterator>
+  void DoInitFromIterator(ForwardIterator first, ForwardIterator last,
+                          jnstl::forward_iterator_tag);
+
+  void DoInsertValuesEnd(size_type n, const value_type& value);
+
+  template <typename... Args>
+  void DoInsertValueFront(Args&&... args);
+  template <typename... Args>
+  void DoInsertValueEnd(Args&&... args);
+
+  size_type DoMask() const;
+  void      DoSwap(this_type& rhs);
+
+  void DoRelocate(pointer pDest);
+  void DoRelocate(pointer pFirst, pointer pLast, pointer pDest,
+                  std::true_type);
+  void DoRelocate(pointer pFirst, pointer pLast, pointer pDest,
+                  std::false_type);
+  void DoReallocate(size_type n);
+
+  static size_type sCapacityFor(size_type n);
+
+  /* Capacity of the first buffer */
+  static const size_type kMinCapacity = 8;
+};
+
+
+// DequeBase //
+
+template <typename T, typename Allocator>
+inline DequeBase<T, Allocator>::DequeBase()
+    : mData(nullptr),
+      mCapacity(0),
+      mHead(0),
+      mSize(0),
+      mAllocator() {}
+
+template <typename T, typename Allocator>
+inline DequeBase<T, Allocator>::DequeBase(const allocator_type& allocator)
+    : mData(nullptr),
+      mCapacity(0),
+      mHead(0),
+      mSize(0),
+      mAllocator(allocator) {}
+
+template <typename T, typename Allocator>
+inline DequeBase<T, Allocator>::~DequeBase() {
+  DoDestructAll();
+  if (mData != nullptr)
+    DoFree(mData, mCapacity);
+}
+
+template <typename T, typename Allocator>
+inline T* DequeBase<T, Allocator>::DoAllocate(size_type n) {
+  /* Over-aligned types need more than what malloc guarantees */
+  if (alignof(T) > JNSTL_MALLOC_ALIGNMENT)
+    return static_cast<T*>(mAllocator.allocate(n * sizeof(T), alignof(T), 0));
+
+  return static_cast<T*>(mAllocator.allocate(n * sizeof(T)));
+}
+
+template <typename T, typename Allocator>
+inline void DequeBase<T, Allocator>::DoFree(T* p, size_type n) {
+  mAllocator.deallocate(static_cast<void *>(p), n * sizeof(T));
+}
+
+/* Destroys the elements, which are left in place */
+template <typename T, typename Allocator>
+inline void DequeBase<T, Allocator>::DoDestructAll() {
+  const size_type nFirst = (mCapacity - mHead < mSize) ? mCapacity - mHead
+                                                       : mSize;
+
+  jnstl::Destruct(mData + mHead, mData + mHead + nFirst);
+  jnstl::Destruct(mData, mData + (mSize - nFirst));
+}
+
+// deque //
+
+template <typename T, typename Allocator>
+inline deque<T, Allocator>::deque()
+    : base_type() {}
+
+template <typename T, typename Allocator>
+inline deque<T, Allocator>::deque(const allocator_type& allocator)
+    : base_type(allocator) {}
+
+template <typename T, typename Allocator>
+inline deque<T, Allocator>::deque(size_type n, const allocator_type& allocator)
+    : base_type(allocator) {
+  DoInsertValuesEnd(n, value_type());
+}
+
+template <typename T, typename Allocator>
+inline deque<T, Allocator>::deque(size_type n, const value_type& value,
+                                  const allocator_type& allocator)
+    : base_type(allocator) {
+  DoInsertValuesEnd(n, value);
+}
+
+template <typename T, typename Allocator>
+template <typename InputIterator>
+inline deque<T, Allocator>::deque(InputIterator first, InputIterator last,
+                                  const allocator_type& allocator)
+    : base_type(allocator) {
+  DoInit(first, last, std::is_integral<InputIterator>());
+}
+
+template <typename T, typename Allocator>
+inline deque<T, Allocator>::deque(std::initializer_list<value_type> ilist,
+                                  const allocator_type& allocator)
+    : base_type(allocator) {
+  DoInit(ilist.begin(), ilist.end(), std::false_type());
+}
+
+template <typename T, typename Allocator>
+inline deque<T, Allocator>::deque(const this_type& rhs)
+    : base_type(rhs.mAllocator) {
+  DoInit(rhs.begin(), rhs.end(), std::false_type());
+}
+
+template <typename T, typename Allocator>
+inline deque<T, Allocator>::deque(const this_type& rhs,
+                                  const allocator_type& allocator)
+    : base_type(allocator) {
+  DoInit(rhs.begin(), rhs.end(), std::false_type());
+}
+
+template <typename T, typename Allocator>
+inline deque<T, Allocator>::deque(this_type&& rhs)
+    : base_type(LIB::move(rhs.mAllocator)) {
+  swap(rhs);
+}
+
+template <typename T, typename Allocator>
+inline deque<T, Allocator>::deque(this_type&& rhs,
+                                  const allocator_type& allocator)
+    : base_type(allocator) {
+  swap(rhs);
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::this_type&
+deque<T, Allocator>::operator=(const this_type& rhs) {
+  if (this != &rhs) {
+    clear();
+    if (mAllocator != rhs.mAllocator) {
+      if (mData != nullptr)
+        DoFree(mData, mCapacity);
+      mData = nullptr;
+      mCapacity = 0;
+      mAllocator = rhs.mAllocator;
+    }
+
+    reserve(rhs.mSize);
+    for (const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+      push_back(*it);
+  }
+
+  return *this;
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::this_type&
+deque<T, Allocator>::operator=(this_type&& rhs) {
+  if (this != &rhs) {
+    clear();
+    swap(rhs);
+  }
+
+  return *this;
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::swap(this_type& rhs) {
+  if (mAllocator == rhs.mAllocator) {
+    DoSwap(rhs);
+  } else {
+    this_type temp(*this);
+
+    *this = rhs;
+    rhs = temp;
+  }
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::reference
+deque<T, Allocator>::operator[](size_type i) {
+  return mData[(mHead + i) & DoMask()];
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::const_reference
+deque<T, Allocator>::operator[](size_type i) const {
+  return mData[(mHead + i) & DoMask()];
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::reference
+deque<T, Allocator>::at(size_type i) {
+#if JNSTL_EXCEPTIONS_ENABLED
+  if (i >= size()) {
+    throw;
+  }
+#endif
+  return (*this)[i];
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::const_reference
+deque<T, Allocator>::at(size_type i) const {
+#if JNSTL_EXCEPTIONS_ENABLED
+  if (i >= size()) {
+    throw;
+  }
+#endif
+  return (*this)[i];
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::iterator deque<T, Allocator>::begin() {
+  return iterator(mData, DoMask(), mHead);
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::const_iterator
+deque<T, Allocator>::begin() const {
+  return const_iterator(mData, DoMask(), mHead);
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::iterator deque<T, Allocator>::end() {
+  return iterator(mData, DoMask(), mHead + mSize);
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::const_iterator
+deque<T, Allocator>::end() const {
+  return const_iterator(mData, DoMask(), mHead + mSize);
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::reverse_iterator
+deque<T, Allocator>::rbegin() {
+  return reverse_iterator(end());
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::const_reverse_iterator
+deque<T, Allocator>::rbegin() const {
+  return const_reverse_iterator(end());
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::reverse_iterator
+deque<T, Allocator>::rend() {
+  return reverse_iterator(begin());
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::const_reverse_iterator
+deque<T, Allocator>::rend() const {
+  return const_reverse_iterator(begin());
+}
+
+template <typename T, typename Allocator>
+inline bool deque<T, Allocator>::empty() const {
+  return mSize == 0;
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::size_type
+deque<T, Allocator>::size() const {
+  return mSize;
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::size_type
+deque<T, Allocator>::capacity() const {
+  return mCapacity;
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::resize(size_type n, const value_type& value) {
+  if (n > mSize) {
+    DoInsertValuesEnd(n - mSize, value);
+  } else {
+    while (mSize > n)
+      pop_back();
+  }
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::reserve(size_type n) {
+  if (n > mCapacity)
+    DoReallocate(sCapacityFor(n));
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::shrink_to_fit() {
+  if (mSize == 0) {
+    if (mData != nullptr)
+      DoFree(mData, mCapacity);
+    mData = nullptr;
+    mCapacity = 0;
+    mHead = 0;
+  } else if (sCapacityFor(mSize) < mCapacity) {
+    DoReallocate(sCapacityFor(mSize));
+  }
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::reference deque<T, Allocator>::front() {
+  return mData[mHead];
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::const_reference
+deque<T, Allocator>::front() const {
+  return mData[mHead];
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::reference deque<T, Allocator>::back() {
+  return mData[(mHead + mSize - 1) & DoMask()];
+}
+
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::const_reference
+deque<T, Allocator>::back() const {
+  return mData[(mHead + mSize - 1) & DoMask()];
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::push_front(const value_type& value) {
+  emplace_front(value);
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::push_front(value_type&& value) {
+  emplace_front(LIB::move(value));
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::push_back(const value_type& value) {
+  emplace_back(value);
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::push_back(value_type&& value) {
+  emplace_back(LIB::move(value));
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::pop_front() {
+  jnstl::Destruct(mData + mHead);
+  mHead = (mHead + 1) & DoMask();
+  --mSize;
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::pop_back() {
+  --mSize;
+  jnstl::Destruct(mData + ((mHead + mSize) & DoMask()));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+inline typename deque<T, Allocator>::reference
+deque<T, Allocator>::emplace_front(Args&&... args) {
+  if (mSize < mCapacity) {
+    const size_type head = (mHead - 1) & DoMask();
+
+    jnstl::Construct(mData + head, LIB::forward<Args>(args)...);
+    mHead = head;
+    ++mSize;
+  } else {
+    DoInsertValueFront(LIB::forward<Args>(args)...);
+  }
+
+  return mData[mHead];
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+inline typename deque<T, Allocator>::reference
+deque<T, Allocator>::emplace_back(Args&&... args) {
+  if (mSize < mCapacity) {
+    jnstl::Construct(mData + ((mHead + mSize) & DoMask()),
+                     LIB::forward<Args>(args)...);
+    ++mSize;
+  } else {
+    DoInsertValueEnd(LIB::forward<Args>(args)...);
+  }
+
+  return back();
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::clear() {
+  DoDestructAll();
+  mHead = 0;
+  mSize = 0;
+}
+
+template <typename T, typename Allocator>
+inline bool deque<T, Allocator>::validate() const {
+  if (mCapacity & (mCapacity - 1))
+    return false;
+  if ((mData == nullptr) != (mCapacity == 0))
+    return false;
+  if (mSize > mCapacity)
+    return false;
+  if (mHead != 0 && mHead >= mCapacity)
+    return false;
+
+  return true;
+}
+
+template <typename T, typename Allocator>
+template <typename Integer>
+inline void deque<T, Allocator>::DoInit(Integer n, Integer value,
+                                        std::true_type) {
+  DoInsertValuesEnd(static_cast<size_type>(n), static_cast<value_type>(value));
+}
+
+template <typename T, typename Allocator>
+template <typename InputIterator>
+inline void deque<T, Allocator>::DoInit(InputIterator first,
+                                        InputIterator last, std::false_type) {
+  typedef typename
+      jnstl::iterator_traits<InputIterator>::iterator_category category;
+
+  DoInitFromIterator(first, last, category());
+}
+
+template <typename T, typename Allocator>
+template <typename InputIterator>
+inline void deque<T, Allocator>::DoInitFromIterator(
+    InputIterator first, InputIterator last, jnstl::input_iterator_tag) {
+  for (; first != last; ++first)
+    emplace_back(*first);
+}
+
+template <typename T, typename Allocator>
+template <typename ForwardIterator>
+inline void deque<T, Allocator>::DoInitFromIterator(
+    ForwardIterator first, ForwardIterator last, jnstl::forward_iterator_tag) {
+  const size_type n = static_cast<size_type>(jnstl::distance(first, last));
+
+  if (n != 0) {
+    mData = DoAllocate(sCapacityFor(n));
+    mCapacity = sCapacityFor(n);
+    jnstl::uninitialized_copy(first, last, mData);
+    mSize = n;
+  }
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::DoInsertValuesEnd(size_type n,
+                                            const value_type& value) {
+  if (mSize + n > mCapacity) {
+    /* value may be an element of this deque */
+    const value_type temp(value);
+
+    DoReallocate(sCapacityFor(mSize + n));
+    for (; n != 0; --n)
+      emplace_back(temp);
+  } else {
+    for (; n != 0; --n)
+      emplace_back(value);
+  }
+}
+
+/* The buffer is full: the new element goes to the last slot of a buffer
+   twice as large, the others after it at its start. args may refer to an
+   element of this deque, so the new element is constructed before the old
+   ones are relocated. */
+template <typename T, typename Allocator>
+template <typename... Args>
+void deque<T, Allocator>::DoInsertValueFront(Args&&... args) {
+  const size_type nNew = sCapacityFor(mSize + 1);
+  pointer const pNewData = DoAllocate(nNew);
+
+  jnstl::Construct(pNewData + nNew - 1, LIB::forward<Args>(args)...);
+  DoRelocate(pNewData);
+  if (mData != nullptr)
+    DoFree(mData, mCapacity);
+
+  mData = pNewData;
+  mCapacity = nNew;
+  mHead = nNew - 1;
+  ++mSize;
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void deque<T, Allocator>::DoInsertValueEnd(Args&&... args) {
+  const size_type nNew = sCapacityFor(mSize + 1);
+  pointer const pNewData = DoAllocate(nNew);
+
+  jnstl::Construct(pNewData + mSize, LIB::forward<Args>(args)...);
+  DoRelocate(pNewData);
+  if (mData != nullptr)
+    DoFree(mData, mCapacity);
+
+  mData = pNewData;
+  mCapacity = nNew;
+  mHead = 0;
+  ++mSize;
+}
+
+/* Reduces positions to slots of the buffer. Without a buffer the mask has
+   all its bits set, which leaves positions as they are. */
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::size_type
+deque<T, Allocator>::DoMask() const {
+  return mCapacity - 1;
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::DoSwap(this_type& rhs) {
+  LIB::swap(mData,      rhs.mData);
+  LIB::swap(mCapacity,  rhs.mCapacity);
+  LIB::swap(mHead,      rhs.mHead);
+  LIB::swap(mSize,      rhs.mSize);
+  LIB::swap(mAllocator, rhs.mAllocator);
+}
+
+/* Moves the elements, in order, to [pDest, pDest + size()). The old slots
+   are left destroyed. */
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::DoRelocate(pointer pDest) {
+  const size_type nFirst = (mCapacity - mHead < mSize) ? mCapacity - mHead
+                                                       : mSize;
+
+  DoRelocate(mData + mHead, mData + mHead + nFirst, pDest,
+             jnstl::is_trivially_relocatable<T>());
+  DoRelocate(mData, mData + (mSize - nFirst), pDest + nFirst,
+             jnstl::is_trivially_relocatable<T>());
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::DoRelocate(pointer pFirst, pointer pLast,
+                                            pointer pDest, std::true_type) {
+  if (pFirst != pLast)
+    memcpy(static_cast<void*>(pDest), static_cast<const void*>(pFirst),
+           (size_type)(pLast - pFirst) * sizeof(T));
+}
+
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::DoRelocate(pointer pFirst, pointer pLast,
+                                            pointer pDest, std::false_type) {
+  jnstl::uninitialized_move(pFirst, pLast, pDest);
+  jnstl::Destruct(pFirst, pLast);
+}
+
+/* Moves the elements to the start of a buffer of capacity n >= size(), a
+   power of two */
+template <typename T, typename Allocator>
+void deque<T, Allocator>::DoReallocate(size_type n) {
+  pointer const pNewData = DoAllocate(n);
+
+  DoRelocate(pNewData);
+  if (mData != nullptr)
+    DoFree(mData, mCapacity);
+
+  mData = pNewData;
+  mCapacity = n;
+  mHead = 0;
+}
+
+/* Smallest power of two holding n elements, at least kMinCapacity */
+template <typename T, typename Allocator>
+inline typename deque<T, Allocator>::size_type
+deque<T, Allocator>::sCapacityFor(size_type n) {
+  size_type capacity = kMinCapacity;
+
+  while (capacity < n)
+    capacity *= 2;
+  return capacity;
+}
+
+template <typename T, typename Allocator>
+const typename deque<T, Allocator>::size_type
+deque<T, Allocator>::kMinCapacity;
+
+// Global //
+
+template <typename T, typename Pointer1, typename Reference1,
+          typename Pointer2, typename Reference2>
+inline bool operator==(const DequeIterator<T, Pointer1, Reference1>& a,
+                       const DequeIterator<T, Pointer2, Reference2>& b) {
+  return a.mIndex == b.mIndex;
+}
+
+template <typename T, typename Pointer1, typename Reference1,
+          typename Pointer2, typename Reference2>
+inline bool operator!=(const DequeIterator<T, Pointer1, Reference1>& a,
+                       const DequeIterator<T, Pointer2, Reference2>& b) {
+  return a.mIndex != b.mIndex;
+}
+
+template <typename T, typename Pointer1, typename Reference1,
+          typename Pointer2, typename Reference2>
+inline bool operator<(const DequeIterator<T, Pointer1, Reference1>& a,
+                      const DequeIterator<T, Pointer2, Reference2>& b) {
+  return a.mIndex < b.mIndex;
+}
+
+template <typename T, typename Pointer1, typename Reference1,
+          typename Pointer2, typename Reference2>
+inline bool operator>(const DequeIterator<T, Pointer1, Reference1>& a,
+                      const DequeIterator<T, Pointer2, Reference2>& b) {
+  return b.mIndex < a.mIndex;
+}
+
+template <typename T, typename Pointer1, typename Reference1,
+          typename Pointer2, typename Reference2>
+inline bool operator<=(const DequeIterator<T, Pointer1, Reference1>& a,
+                       const DequeIterator<T, Pointer2, Reference2>& b) {
+  return !(b.mIndex < a.mIndex);
+}
+
+template <typename T, typename Pointer1, typename Reference1,
+          typename Pointer2, typename Reference2>
+inline bool operator>=(const DequeIterator<T, Pointer1, Reference1>& a,
+                       const DequeIterator<T, Pointer2, Reference2>& b) {
+  return !(a.mIndex < b.mIndex);
+}
+
+template <typename T, typename Pointer1, typename Reference1,
+          typename Pointer2, typename Reference2>
+inline ptrdiff_t operator-(const DequeIterator<T, Pointer1, Reference1>& a,
+                           const DequeIterator<T, Pointer2, Reference2>& b) {
+  return (ptrdiff_t)(a.mIndex - b.mIndex);
+}
+
+template <typename T, typename Pointer, typename Reference>
+inline DequeIterator<T, Pointer, Reference>
+operator+(ptrdiff_t n, const DequeIterator<T, Pointer, Reference>& x) {
+  return x + n;
+}
+
+template <typename T, typename Allocator>
+inline bool operator==(const deque<T, Allocator>& a,
+                       const deque<T, Allocator>& b) {
+  return ((a.size() == b.size()) &&
+          jnstl::equal(a.begin(), a.end(), b.begin()));
+}
+
+template <typename T, typename Allocator>
+inline bool operator<(const deque<T, Allocator>& a,
+                      const deque<T, Allocator>& b) {
+  return std::lexicographical_compare(a.begin(), a.end(),
+                                      b.begin(), b.end());
+}
+
+template <typename T, typename Allocator>
+inline bool operator!=(const deque<T, Allocator>& a,
+                       const deque<T, Allocator>& b) {
+  return !(a == b);
+}
+
+template <typename T, typename Allocator>
+inline bool operator>(const deque<T, Allocator>& a,
+                      const deque<T, Allocator>& b) {
+  return b < a;
+}
+
+template <typename T, typename Allocator>
+inline bool operator<=(const deque<T, Allocator>& a,
+                       const deque<T, Allocator>& b) {
+  return !(b < a);
+}
+
+template <typename T, typename Allocator>
+inline bool operator>=(const deque<T, Allocator>& a,
+                       const deque<T, Allocator>& b) {
+  return !(a < b);
+}
+
+template <typename T, typename Allocator>
+inline void swap(deque<T, Allocator>& a, deque<T, Allocator>& b) {
+  a.swap(b);
+}
+}  // namespace jnstl
+
+#endif /* JNSTL_DEQUE_H_ */
@@ -435,6 +435,20 @@ operator>=(const normal_iterator<Iterator, Container>& lhs,
   return lhs.base() >= rhs.base();
 }
 
+/* Inverse of niter_base: the iterator of the type of from at res, res being
+   obtained from niter_base(from). */
+template <typename Iterator>
+inline Iterator
+niter_wrap(Iterator, Iterator res) {
+  return res;
+}
+
+template <typename Iterator, typename Container>
+inline normal_iterator<Iterator, Container>
+niter_wrap(normal_iterator<Iterator, Container> from, Iterator res) {
+  return from + (res - from.base());
+}
+
 template <typename Iterator>
 class move_iterator {
   // Don't inherit from iterator.
@@ -1076,7 +1076,7 @@ list<T, Allocator>::DoSort(iterator lo1, iterator hi2, size_type n,
   size_type nMid = n/2;
   iterator hi1(lo1);
 
-  advance(hi1, nMid);
+  jnstl::advance(hi1, nMid);
 
            lo1 = DoSort(lo1, hi1, nMid, compare);
   iterator lo2 = DoSort(hi1, hi2, n - nMid, compare);
@@ -1152,7 +1152,7 @@ inline bool operator!=(const ListConstIterator<T>& a,
 template <typename T, typename Allocator>
 inline bool operator==(const list<T, Allocator>& a,
                        const list<T, Allocator>& b) {
-  return equal(a.begin(), a.end(), b.begin());
+  return jnstl::equal(a.begin(), a.end(), b.begin());
 }
 
 template <typename T, typename Allocator>
@@ -66,6 +66,16 @@ class map {
     mT.DoInsertUnique(first, last);
   }
 
+  // [first, last) must be sorted by compare, without duplicate keys. The
+  // tree is then built in linear time.
+  template<typename InputIterator>
+  map(sorted_unique_t, InputIterator first, InputIterator last,
+      const Compare& compare = Compare(),
+      const allocator_type& a = allocator_type())
+      : mT(compare, a) {
+    mT.DoInsertSorted(first, last, true);
+  }
+
   map(const map& x)
       : mT(x.mT) {}
 
@@ -142,22 +152,12 @@ class map {
 
   mapped_type&
   operator[](const key_type& key) {
-    iterator i = lower_bound(key);
-
-    if (i == end() || key_comp()(key, (*i).first))
-      i = insert(i, value_type(key, mapped_type()));
-
-    return (*i).second;
+    return (*try_emplace(key).first).second;
   }
 
   mapped_type&
-  operator[](key_type& key) {
-    iterator i = lower_bound(key);
-
-    if (i == end() || key_comp()(key, (*i).first))
-      i = insert(i, value_type(LIB::move(key), mapped_type()));
-
-    return (*i).second;
+  operator[](key_type&& key) {
+    return (*try_emplace(LIB::move(key)).first).second;
   }
 
   mapped_type&
@@ -188,7 +188,7 @@ class map {
   }
 
   jnstl::pair<iterator, bool>
-  insert(const value_type&& x) {
+  insert(value_type&& x) {
     jnstl::pair<typename rep_type::iterator, bool> p =
         mT.DoInsertUnique(LIB::move(x));
     return jnstl::pair<iterator, bool>(p.first, p.second);
@@ -200,7 +200,7 @@ class map {
   }
 
   iterator
-  insert(const_iterator position, const value_type&& x) {
+  insert(const_iterator position, value_type&& x) {
     return mT.DoInsertUnique(position, LIB::move(x));
   }
 
@@ -210,11 +210,107 @@ class map {
     mT.DoInsertUnique(first, last);
   }
 
+  template<typename InputIterator>
+  void
+  insert(sorted_unique_t, InputIterator first, InputIterator last) {
+    mT.DoInsertSorted(first, last, true);
+  }
+
   void
   insert(std::initializer_list<value_type> ilist) {
     this->insert(ilist.begin(), ilist.end());
   }
 
+  template <typename... Args>
+  jnstl::pair<iterator, bool>
+  emplace(Args&&... args) {
+    jnstl::pair<typename rep_type::iterator, bool> p =
+        mT.DoEmplaceUnique(LIB::forward<Args>(args)...);
+    return jnstl::pair<iterator, bool>(p.first, p.second);
+  }
+
+  template <typename... Args>
+  iterator
+  emplace_hint(const_iterator position, Args&&... args) {
+    return mT.DoEmplaceUniqueHint(position, LIB::forward<Args>(args)...);
+  }
+
+  // The value is only constructed, from key and args, if key is absent.
+  template <typename... Args>
+  jnstl::pair<iterator, bool>
+  try_emplace(const key_type& key, Args&&... args) {
+    return mT.DoInsertUniqueKey(key, std::piecewise_construct,
+                                std::forward_as_tuple(key),
+                                std::forward_as_tuple(
+                                    LIB::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  jnstl::pair<iterator, bool>
+  try_emplace(key_type&& key, Args&&... args) {
+    return mT.DoInsertUniqueKey(key, std::piecewise_construct,
+                                std::forward_as_tuple(LIB::move(key)),
+                                std::forward_as_tuple(
+                                    LIB::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator
+  try_emplace(const_iterator position, const key_type& key, Args&&... args) {
+    return mT.DoInsertUniqueKey(position, key, std::piecewise_construct,
+                                std::forward_as_tuple(key),
+                                std::forward_as_tuple(
+                                    LIB::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator
+  try_emplace(const_iterator position, key_type&& key, Args&&... args) {
+    return mT.DoInsertUniqueKey(position, key, std::piecewise_construct,
+                                std::forward_as_tuple(LIB::move(key)),
+                                std::forward_as_tuple(
+                                    LIB::forward<Args>(args)...));
+  }
+
+  template <typename M>
+  jnstl::pair<iterator, bool>
+  insert_or_assign(const key_type& key, M&& obj) {
+    jnstl::pair<iterator, bool> p = try_emplace(key, LIB::forward<M>(obj));
+    if (!p.second)
+      (*p.first).second = LIB::forward<M>(obj);
+    return p;
+  }
+
+  template <typename M>
+  jnstl::pair<iterator, bool>
+  insert_or_assign(key_type&& key, M&& obj) {
+    jnstl::pair<iterator, bool> p = try_emplace(LIB::move(key),
+                                                LIB::forward<M>(obj));
+    if (!p.second)
+      (*p.first).second = LIB::forward<M>(obj);
+    return p;
+  }
+
+  template <typename M>
+  iterator
+  insert_or_assign(const_iterator position, const key_type& key, M&& obj) {
+    const size_type n = size();
+    iterator i = try_emplace(position, key, LIB::forward<M>(obj));
+    if (size() == n)
+      (*i).second = LIB::forward<M>(obj);
+    return i;
+  }
+
+  template <typename M>
+  iterator
+  insert_or_assign(const_iterator position, key_type&& key, M&& obj) {
+    const size_type n = size();
+    iterator i = try_emplace(position, LIB::move(key), LIB::forward<M>(obj));
+    if (size() == n)
+      (*i).second = LIB::forward<M>(obj);
+    return i;
+  }
+
   iterator
   erase(const_iterator position) {
     return mT.erase(position);
@@ -280,6 +376,71 @@ class map {
     return mT.equal_range(x);
   }
 
+  // Lookup with any type comparable to key_type, when key_compare is
+  // transparent (e.g. std::less<>). No temporary key is constructed.
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  size_type
+  count(const K& x) const {
+    return mT.find(x) == mT.end() ? 0 : 1;
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  find(const K& x) {
+    return mT.find(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  find(const K& x) const {
+    return mT.find(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  lower_bound(const K& x) {
+    return mT.lower_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  lower_bound(const K& x) const {
+    return mT.lower_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  upper_bound(const K& x) {
+    return mT.upper_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  upper_bound(const K& x) const {
+    return mT.upper_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  jnstl::pair<iterator, iterator>
+  equal_range(const K& x) {
+    return mT.equal_range(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  jnstl::pair<const_iterator, const_iterator>
+  equal_range(const K& x) const {
+    return mT.equal_range(x);
+  }
+
   bool
   validate() const {
     return mT.validate();
@@ -66,6 +66,16 @@ class multimap {
     mT.DoInsertMulti(first, last);
   }
 
+  // [first, last) must be sorted by compare. The tree is then
+  // built in linear time.
+  template<typename InputIterator>
+  multimap(sorted_equivalent_t, InputIterator first, InputIterator last,
+      const Compare& compare = Compare(),
+      const allocator_type& a = allocator_type())
+      : mT(compare, a) {
+    mT.DoInsertSorted(first, last, false);
+  }
+
   multimap(const multimap& x)
       : mT(x.mT) {}
 
@@ -146,7 +156,7 @@ class multimap {
   }
 
   iterator
-  insert(const value_type&& x) {
+  insert(value_type&& x) {
     return mT.DoInsertMulti(LIB::move(x));
   }
 
@@ -156,7 +166,7 @@ class multimap {
   }
 
   iterator
-  insert(const_iterator position, const value_type&& x) {
+  insert(const_iterator position, value_type&& x) {
     return mT.DoInsertMulti(position, LIB::move(x));
   }
 
@@ -166,11 +176,29 @@ class multimap {
     mT.DoInsertMulti(first, last);
   }
 
+  template<typename InputIterator>
+  void
+  insert(sorted_equivalent_t, InputIterator first, InputIterator last) {
+    mT.DoInsertSorted(first, last, false);
+  }
+
   void
   insert(std::initializer_list<value_type> ilist) {
     this->insert(ilist.begin(), ilist.end());
   }
 
+  template <typename... Args>
+  iterator
+  emplace(Args&&... args) {
+    return mT.DoEmplaceMulti(LIB::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  iterator
+  emplace_hint(const_iterator position, Args&&... args) {
+    return mT.DoEmplaceMultiHint(position, LIB::forward<Args>(args)...);
+  }
+
   iterator
   erase(const_iterator position) {
     return mT.erase(position);
@@ -193,7 +221,8 @@ class multimap {
 
   size_type
   count(const key_type& x) const {
-    return mT.find(x) == mT.end() ? 0 : 1;
+    jnstl::pair<const_iterator, const_iterator> p = mT.equal_range(x);
+    return static_cast<size_type>(jnstl::distance(p.first, p.second));
   }
 
   iterator
@@ -236,6 +265,72 @@ class multimap {
     return mT.equal_range(x);
   }
 
+  // Lookup with any type comparable to key_type, when key_compare is
+  // transparent (e.g. std::less<>). No temporary key is constructed.
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  size_type
+  count(const K& x) const {
+    jnstl::pair<const_iterator, const_iterator> p = mT.equal_range(x);
+    return static_cast<size_type>(jnstl::distance(p.first, p.second));
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  find(const K& x) {
+    return mT.find(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  find(const K& x) const {
+    return mT.find(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  lower_bound(const K& x) {
+    return mT.lower_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  lower_bound(const K& x) const {
+    return mT.lower_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  upper_bound(const K& x) {
+    return mT.upper_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  upper_bound(const K& x) const {
+    return mT.upper_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  jnstl::pair<iterator, iterator>
+  equal_range(const K& x) {
+    return mT.equal_range(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  jnstl::pair<const_iterator, const_iterator>
+  equal_range(const K& x) const {
+    return mT.equal_range(x);
+  }
+
   bool
   validate() const {
     return mT.validate();
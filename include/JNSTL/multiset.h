@@ -52,6 +52,16 @@ class multiset {
     mT.DoInsertMulti(first, last);
   }
 
+  // [first, last) must be sorted by compare. The tree is then
+  // built in linear time.
+  template<typename InputIterator>
+  multiset(sorted_equivalent_t, InputIterator first, InputIterator last,
+           const Compare& compare = Compare(),
+           const allocator_type& a = allocator_type())
+      : mT(compare, a) {
+    mT.DoInsertSorted(first, last, false);
+  }
+
   multiset(const multiset& x)
       : mT(x.mT) {}
 
@@ -132,7 +142,7 @@ class multiset {
   }
 
   iterator
-  insert(const value_type&& x) {
+  insert(value_type&& x) {
     return mT.DoInsertMulti(LIB::move(x));
   }
 
@@ -142,7 +152,7 @@ class multiset {
   }
 
   iterator
-  insert(const_iterator position, const value_type&& x) {
+  insert(const_iterator position, value_type&& x) {
     return mT.DoInsertMulti(position, LIB::move(x));
   }
 
@@ -152,11 +162,29 @@ class multiset {
     mT.DoInsertMulti(first, last);
   }
 
+  template<typename InputIterator>
+  void
+  insert(sorted_equivalent_t, InputIterator first, InputIterator last) {
+    mT.DoInsertSorted(first, last, false);
+  }
+
   void
   insert(std::initializer_list<value_type> ilist) {
     this->insert(ilist.begin(), ilist.end());
   }
 
+  template <typename... Args>
+  iterator
+  emplace(Args&&... args) {
+    return mT.DoEmplaceMulti(LIB::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  iterator
+  emplace_hint(const_iterator position, Args&&... args) {
+    return mT.DoEmplaceMultiHint(position, LIB::forward<Args>(args)...);
+  }
+
   iterator
   erase(const_iterator position) {
     return mT.erase(position);
@@ -179,7 +207,8 @@ class multiset {
 
   size_type
   count(const key_type& x) const {
-    return mT.find(x) == mT.end() ? 0 : 1;
+    jnstl::pair<const_iterator, const_iterator> p = mT.equal_range(x);
+    return static_cast<size_type>(jnstl::distance(p.first, p.second));
   }
 
   iterator
@@ -222,6 +251,72 @@ class multiset {
     return mT.equal_range(x);
   }
 
+  // Lookup with any type comparable to key_type, when key_compare is
+  // transparent (e.g. std::less<>). No temporary key is constructed.
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  size_type
+  count(const K& x) const {
+    jnstl::pair<const_iterator, const_iterator> p = mT.equal_range(x);
+    return static_cast<size_type>(jnstl::distance(p.first, p.second));
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  find(const K& x) {
+    return mT.find(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  find(const K& x) const {
+    return mT.find(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  lower_bound(const K& x) {
+    return mT.lower_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  lower_bound(const K& x) const {
+    return mT.lower_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  upper_bound(const K& x) {
+    return mT.upper_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  upper_bound(const K& x) const {
+    return mT.upper_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  jnstl::pair<iterator, iterator>
+  equal_range(const K& x) {
+    return mT.equal_range(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  jnstl::pair<const_iterator, const_iterator>
+  equal_range(const K& x) const {
+    return mT.equal_range(x);
+  }
+
   bool
   validate() const {
     return mT.validate();
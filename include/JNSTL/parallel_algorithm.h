@@ -0,0 +1,563 @@
+#ifndef JNSTL_PARALLEL_ALGORITHM_H_
+#define JNSTL_PARALLEL_ALGORITHM_H_
+
+#include <functional>
+#include <vector>
+
+#include "JNSTL/bits/config.h"
+#include "JNSTL/bits/executor.h"
+#include "JNSTL/algorithm.h"
+
+namespace jnstl {
+
+/* Ranges smaller than this are sorted sequentially, splitting them further
+   costs more in task overhead than it brings in parallelism. */
+const ptrdiff_t parallel_sort_cutoff = 1 << 14;
+
+/* Size of the output pieces merges are split into */
+const ptrdiff_t parallel_merge_grain = 1 << 14;
+
+/* Sample elements taken per output piece of a multiway merge */
+const ptrdiff_t parallel_multiway_oversampling = 8;
+
+/* pdqsort_loop whose left partitions are handed to the executor down to
+   parallel_sort_cutoff elements. Pivots are final once placed and never
+   touched by another task, so the element before first stays a valid
+   sentinel for the duplicate detection and the unguarded insertion sort. */
+template <bool Block, typename RandomIt, typename Compare>
+void
+parallel_sort_task(jnstl::parallel_executor& executor,
+                   RandomIt first, RandomIt last, Compare comp,
+                   int bad_allowed, bool leftmost) {
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  while (last - first > parallel_sort_cutoff) {
+    const difference_type size = last - first;
+
+    jnstl::pdq_choose_pivot(first, last, comp);
+
+    if (!leftmost && !comp(*(first - 1), *first)) {
+      first = jnstl::pdq_partition_left(first, last, comp) + 1;
+      continue;
+    }
+
+    const jnstl::pair<RandomIt, bool> part =
+        jnstl::pdq_partitioner<Block>::partition_right(first, last, comp);
+    const RandomIt pivot_pos = part.first;
+    const difference_type l_size = pivot_pos - first;
+    const difference_type r_size = last - (pivot_pos + 1);
+
+    if (l_size < size / 8 || r_size < size / 8) {
+      if (--bad_allowed == 0) {
+        jnstl::partial_sort_impl(first, last, last, comp);
+        return;
+      }
+      jnstl::pdq_break_patterns(first, pivot_pos, l_size);
+      jnstl::pdq_break_patterns(pivot_pos + 1, last, r_size);
+    } else if (part.second &&
+               jnstl::partial_insertion_sort(first, pivot_pos, comp) &&
+               jnstl::partial_insertion_sort(pivot_pos + 1, last, comp)) {
+      return;
+    }
+
+    const RandomIt left_first = first;
+    const bool left_leftmost = leftmost;
+    executor.spawn([&executor, left_first, pivot_pos, comp, bad_allowed,
+                    left_leftmost]() {
+      jnstl::parallel_sort_task<Block>(executor, left_first, pivot_pos, comp,
+                                       bad_allowed, left_leftmost);
+    });
+
+    first = pivot_pos + 1;
+    leftmost = false;
+  }
+
+  if (last - first > 1)
+    jnstl::pdqsort_loop<Block>(first, last, comp, bad_allowed, leftmost);
+}
+
+/* Number of elements of [a, a + na) among the first k elements of the
+   stable merge of [a, a + na) and [b, b + nb). */
+template <typename It1, typename It2, typename Distance, typename Compare>
+Distance
+merge_co_rank(Distance k, It1 a, Distance na, It2 b, Distance nb,
+              Compare comp) {
+  Distance lo = k > nb ? k - nb : 0;
+  Distance hi = k < na ? k : na;
+
+  while (lo < hi) {
+    const Distance i = lo + (hi - lo) / 2;
+
+    /* a[i] is output before b[k - i - 1]: the cut is further in a */
+    if (!comp(*(b + (k - i - 1)), *(a + i)))
+      lo = i + 1;
+    else
+      hi = i;
+  }
+  return lo;
+}
+
+/* Stable merge moving the elements to d_first */
+template <typename It1, typename It2, typename OutputIt, typename Compare>
+OutputIt
+move_merge(It1 first1, It1 last1, It2 first2, It2 last2, OutputIt d_first,
+           Compare comp) {
+  while (first1 != last1 && first2 != last2) {
+    if (comp(*first2, *first1)) {
+      *d_first = LIB::move(*first2);
+      ++first2;
+    } else {
+      *d_first = LIB::move(*first1);
+      ++first1;
+    }
+    ++d_first;
+  }
+  for (; first1 != last1; ++first1, ++d_first)
+    *d_first = LIB::move(*first1);
+  for (; first2 != last2; ++first2, ++d_first)
+    *d_first = LIB::move(*first2);
+  return d_first;
+}
+
+/* Merges [a, a + na) and [b, b + nb) into d_first, split into pieces of
+   about parallel_merge_grain elements merged by separate tasks. The split
+   points are all found before any task starts moving elements out of the
+   ranges the binary searches read. */
+template <typename It1, typename It2, typename OutputIt, typename Distance,
+          typename Compare>
+void
+parallel_merge_pieces(jnstl::parallel_executor& executor,
+                      It1 a, Distance na, It2 b, Distance nb,
+                      OutputIt d_first, Compare comp) {
+  const Distance total = na + nb;
+  const Distance pieces = (total + parallel_merge_grain - 1) /
+                          parallel_merge_grain;
+
+  /* cuts[p] is where piece p starts in a */
+  std::vector<Distance> cuts(pieces + 1);
+
+  cuts[0] = 0;
+  cuts[pieces] = na;
+  for (Distance p = 1; p < pieces; ++p)
+    cuts[p] = jnstl::merge_co_rank(total * p / pieces, a, na, b, nb, comp);
+
+  for (Distance p = 0; p < pieces; ++p) {
+    const Distance k0 = total * p / pieces;
+    const Distance k1 = total * (p + 1) / pieces;
+    const Distance i0 = cuts[p];
+    const Distance i1 = cuts[p + 1];
+
+    executor.spawn([=]() {
+      jnstl::move_merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1),
+                        d_first + k0, comp);
+    });
+  }
+}
+
+/* One level of the bottom-up merge: merges the pairs of adjacent runs of
+   width run boundaries from src into dst. */
+template <typename SrcIt, typename DstIt, typename Distance,
+          typename Compare>
+void
+parallel_merge_level(jnstl::parallel_executor& executor, SrcIt src,
+                     DstIt dst, Distance n, Distance runs, Distance width,
+                     Compare comp) {
+  for (Distance r = 0; r < runs; r += 2 * width) {
+    const Distance lo  = n * r / runs;
+    const Distance mid = n * (r + width) / runs;
+    const Distance hi  = n * (r + 2 * width) / runs;
+
+    jnstl::parallel_merge_pieces(executor, src + lo, mid - lo, src + mid,
+                                 hi - mid, dst + lo, comp);
+  }
+  executor.wait();
+}
+
+/* Stable multiway merge of random access ranges, split into output pieces
+   merged by separate tasks. Splitter values are picked at regular ranks of
+   a sorted sample of the ranges and every range is cut before its first
+   element not less than each splitter, so that a piece holds all the
+   elements equivalent to its first one. The pieces are balanced unless a
+   single value fills a large part of the input. */
+template <typename It, typename OutputIt, typename Compare>
+OutputIt
+parallel_multiway_merge_impl(jnstl::parallel_executor& executor,
+                             jnstl::pair<It, It>* ranges, size_t k,
+                             OutputIt d_first, Compare comp) {
+  typedef typename jnstl::iterator_traits<It>::value_type value_type;
+  typedef typename
+      jnstl::iterator_traits<It>::difference_type difference_type;
+  typedef jnstl::pair<It, It> range;
+
+  difference_type total = 0;
+
+  for (size_t i = 0; i < k; ++i)
+    total += ranges[i].second - ranges[i].first;
+
+  difference_type pieces = total / parallel_merge_grain;
+  if (pieces > 4 * difference_type(executor.concurrency()))
+    pieces = 4 * difference_type(executor.concurrency());
+
+  if (pieces < 2 || executor.concurrency() == 1)
+    return jnstl::multiway_merge_impl<true>(ranges, k, d_first, comp);
+
+  const difference_type samples = pieces * parallel_multiway_oversampling;
+  std::vector<It> sample;
+
+  for (size_t i = 0; i < k; ++i) {
+    const difference_type len = ranges[i].second - ranges[i].first;
+    const difference_type m = (len * samples + total - 1) / total;
+
+    for (difference_type j = 0; j < m; ++j)
+      sample.push_back(ranges[i].first + len * (2 * j + 1) / (2 * m));
+  }
+  jnstl::sort(sample.begin(), sample.end(), [&](const It& a, const It& b) {
+    return comp(*a, *b);
+  });
+
+  /* cuts[p * k + i] is where piece p starts in range i */
+  std::vector<It> cuts((pieces + 1) * k);
+
+  for (size_t i = 0; i < k; ++i) {
+    cuts[i] = ranges[i].first;
+    cuts[pieces * k + i] = ranges[i].second;
+  }
+  for (difference_type p = 1; p < pieces; ++p) {
+    const value_type& splitter = *sample[sample.size() * p / pieces];
+
+    for (size_t i = 0; i < k; ++i) {
+      cuts[p * k + i] = jnstl::merge_partition_point(
+          cuts[(p - 1) * k + i], ranges[i].second,
+          [&](const value_type& x) { return comp(x, splitter); });
+    }
+  }
+
+  difference_type offset = 0;
+
+  for (difference_type p = 0; p < pieces; ++p) {
+    std::vector<range> local(k);
+    difference_type length = 0;
+
+    for (size_t i = 0; i < k; ++i) {
+      local[i] = range(cuts[p * k + i], cuts[(p + 1) * k + i]);
+      length += local[i].second - local[i].first;
+    }
+
+    if (length != 0) {
+      const OutputIt d_piece = d_first + offset;
+
+      executor.spawn([local, d_piece, comp]() mutable {
+        jnstl::multiway_merge_impl<true>(local.data(), local.size(),
+                                         d_piece, comp);
+      });
+    }
+    offset += length;
+  }
+  executor.wait();
+  return d_first + total;
+}
+
+/**
+ * @brief Merges the elements of several sorted ranges using several
+ * threads.
+ * @ingroup sorting_algorithms
+ * @params executor The thread pool to run on.
+ * @params seqFirst An input iterator to the ranges.
+ * @params seqLast  An input iterator to the ranges.
+ * @params d_first  A random access iterator pointing to the beginning of
+ *                  the destination range.
+ * @params comp     A functor to use for comparison.
+ * @return An iterator to the element past the last merged element.
+ *
+ * Same as @p stable_multiway_merge() on ranges of random access iterators.
+ * The output is split into pieces by splitter values searched in every
+ * range, and the pieces are merged in parallel by the threads of
+ * @p executor, each one with its own loser tree. Inputs under
+ * 2 * parallel_merge_grain elements are merged sequentially.
+ */
+template <typename SeqIt, typename RandomIt, typename Compare>
+RandomIt
+parallel_multiway_merge(jnstl::parallel_executor& executor,
+                        SeqIt seqFirst, SeqIt seqLast, RandomIt d_first,
+                        Compare comp) {
+  jnstl::multiway_ranges<SeqIt> ranges(seqFirst, seqLast);
+
+  return jnstl::parallel_multiway_merge_impl(executor, ranges.data(),
+                                             ranges.size(), d_first, comp);
+}
+
+/**
+ * @brief Merges the elements of several sorted ranges using several
+ * threads.
+ * @ingroup sorting_algorithms
+ * @params seqFirst An input iterator to the ranges.
+ * @params seqLast  An input iterator to the ranges.
+ * @params d_first  A random access iterator pointing to the beginning of
+ *                  the destination range.
+ * @params comp     A functor to use for comparison.
+ * @params threads  The number of threads to use, 0 for one per hardware
+ *                  thread.
+ * @return An iterator to the element past the last merged element.
+ *
+ * Same as the executor overload, with a thread pool of @p threads threads
+ * created for the call.
+ */
+template <typename SeqIt, typename RandomIt, typename Compare>
+RandomIt
+parallel_multiway_merge(SeqIt seqFirst, SeqIt seqLast, RandomIt d_first,
+                        Compare comp, unsigned threads = 0) {
+  jnstl::multiway_ranges<SeqIt> ranges(seqFirst, seqLast);
+  ptrdiff_t total = 0;
+
+  for (size_t i = 0; i < ranges.size(); ++i)
+    total += ranges.data()[i].second - ranges.data()[i].first;
+
+  if (total < 2 * parallel_merge_grain || threads == 1)
+    return jnstl::multiway_merge_impl<true>(ranges.data(), ranges.size(),
+                                            d_first, comp);
+
+  jnstl::parallel_executor executor(threads);
+  return jnstl::parallel_multiway_merge_impl(executor, ranges.data(),
+                                             ranges.size(), d_first, comp);
+}
+
+/**
+ * @brief Merges the elements of several sorted ranges using several
+ * threads.
+ * @ingroup sorting_algorithms
+ * @params seqFirst An input iterator to the ranges.
+ * @params seqLast  An input iterator to the ranges.
+ * @params d_first  A random access iterator pointing to the beginning of
+ *                  the destination range.
+ * @return An iterator to the element past the last merged element.
+ *
+ * Same as the other overloads, comparing the elements with operator < and
+ * using one thread per hardware thread.
+ */
+template <typename SeqIt, typename RandomIt>
+inline RandomIt
+parallel_multiway_merge(SeqIt seqFirst, SeqIt seqLast, RandomIt d_first) {
+  typedef typename jnstl::multiway_source<SeqIt>::iterator iterator;
+
+  std::less<typename jnstl::iterator_traits<iterator>::value_type> comp;
+  return jnstl::parallel_multiway_merge(seqFirst, seqLast, d_first, comp);
+}
+
+/**
+ * @brief Sorts the elements in the range [first, last) using several
+ * threads.
+ * @ingroup sorting_algorithms
+ * @params executor The thread pool to run on.
+ * @params first    A random access iterator.
+ * @params last     A random access iterator.
+ * @params comp     A functor to use for comparison.
+ * @return Nothing.
+ *
+ * Same as @p sort(), the partitions of the pattern-defeating quicksort
+ * being sorted in parallel by the threads of @p executor. Ranges under
+ * parallel_sort_cutoff elements are sorted sequentially.
+ * The order of equal elements is not guaranteed to be preserved.
+ */
+template <typename RandomIt, typename Compare>
+void
+parallel_sort(jnstl::parallel_executor& executor,
+              RandomIt first, RandomIt last, Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+
+  if (last - first <= parallel_sort_cutoff || executor.concurrency() == 1) {
+    jnstl::sort(first, last, comp);
+    return;
+  }
+
+  jnstl::parallel_sort_task<
+      jnstl::is_block_partitionable<value_type, Compare>::value>(
+          executor, first, last, comp, jnstl::sort_log2(last - first), true);
+  executor.wait();
+}
+
+/**
+ * @brief Sorts the elements in the range [first, last) using several
+ * threads.
+ * @ingroup sorting_algorithms
+ * @params first   A random access iterator.
+ * @params last    A random access iterator.
+ * @params comp    A functor to use for comparison.
+ * @params threads The number of threads to use, 0 for one per hardware
+ *                 thread.
+ * @return Nothing.
+ *
+ * Same as the executor overload, with a thread pool of @p threads threads
+ * created for the call.
+ */
+template <typename RandomIt, typename Compare>
+void
+parallel_sort(RandomIt first, RandomIt last, Compare comp,
+              unsigned threads = 0) {
+  if (last - first <= parallel_sort_cutoff || threads == 1) {
+    jnstl::sort(first, last, comp);
+    return;
+  }
+
+  jnstl::parallel_executor executor(threads);
+  jnstl::parallel_sort(executor, first, last, comp);
+}
+
+/**
+ * @brief Sorts the elements in the range [first, last) using several
+ * threads.
+ * @ingroup sorting_algorithms
+ * @params first A random access iterator.
+ * @params last  A random access iterator.
+ * @return Nothing.
+ *
+ * Same as the other overloads, comparing the elements with operator < and
+ * using one thread per hardware thread.
+ */
+template <typename RandomIt>
+inline void
+parallel_sort(RandomIt first, RandomIt last) {
+  std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
+  jnstl::parallel_sort(first, last, comp);
+}
+
+/**
+ * @brief Sorts the elements in the range [first, last) using several
+ * threads, preserving the order of equal elements.
+ * @ingroup sorting_algorithms
+ * @params executor The thread pool to run on.
+ * @params first    A random access iterator.
+ * @params last     A random access iterator.
+ * @params comp     A functor to use for comparison.
+ * @return Nothing.
+ *
+ * The range is cut into a power of two number of runs, a few per thread,
+ * which are sorted with @p stable_sort() in parallel, then merged pairwise
+ * level by level through a buffer of the size of the range. Every merge is
+ * split into pieces at positions found by binary search, so that all the
+ * threads take part in the last levels too.
+ * The result only depends on the input, not on the number of threads or on
+ * the scheduling. When the buffer cannot be allocated the range is sorted
+ * by @p stable_sort() on the calling thread.
+ */
+template <typename RandomIt, typename Compare>
+void
+parallel_stable_sort(jnstl::parallel_executor& executor,
+                     RandomIt first, RandomIt last, Compare comp) {
+  typedef typename jnstl::iterator_traits<RandomIt>::value_type value_type;
+  typedef typename
+      jnstl::iterator_traits<RandomIt>::difference_type difference_type;
+
+  const difference_type n = last - first;
+
+  if (n <= parallel_sort_cutoff || executor.concurrency() == 1) {
+    jnstl::stable_sort(first, last, comp);
+    return;
+  }
+
+  jnstl::pair<value_type*, ptrdiff_t> buffer =
+      jnstl::get_temporary_buffer<value_type>(n);
+
+  if (buffer.second != n) {
+    jnstl::return_temporary_buffer(buffer.first);
+    jnstl::stable_sort(first, last, comp);
+    return;
+  }
+
+  jnstl::uninitialized_construct_buf(buffer.first, buffer.first + n, first);
+
+  difference_type runs = 1;
+  while (runs < 4 * difference_type(executor.concurrency()) &&
+         n / (2 * runs) >= parallel_sort_cutoff)
+    runs *= 2;
+
+  for (difference_type r = 0; r < runs; ++r) {
+    const RandomIt lo = first + n * r / runs;
+    const RandomIt hi = first + n * (r + 1) / runs;
+
+    executor.spawn([lo, hi, comp]() { jnstl::stable_sort(lo, hi, comp); });
+  }
+  executor.wait();
+
+  value_type* const pBuffer = buffer.first;
+  bool inBuffer = false;
+
+  for (difference_type width = 1; width < runs; width *= 2) {
+    if (inBuffer)
+      jnstl::parallel_merge_level(executor, pBuffer, first, n, runs, width,
+                                  comp);
+    else
+      jnstl::parallel_merge_level(executor, first, pBuffer, n, runs, width,
+                                  comp);
+    inBuffer = !inBuffer;
+  }
+
+  if (inBuffer) {
+    const difference_type pieces = (n + parallel_merge_grain - 1) /
+                                   parallel_merge_grain;
+
+    for (difference_type p = 0; p < pieces; ++p) {
+      executor.spawn([=]() {
+        const difference_type lo = n * p / pieces;
+        const difference_type hi = n * (p + 1) / pieces;
+        RandomIt it = first + lo;
+
+        for (difference_type i = lo; i < hi; ++i, ++it)
+          *it = LIB::move(pBuffer[i]);
+      });
+    }
+    executor.wait();
+  }
+
+  jnstl::Destruct(pBuffer, pBuffer + n);
+  jnstl::return_temporary_buffer(pBuffer);
+}
+
+/**
+ * @brief Sorts the elements in the range [first, last) using several
+ * threads, preserving the order of equal elements.
+ * @ingroup sorting_algorithms
+ * @params first   A random access iterator.
+ * @params last    A random access iterator.
+ * @params comp    A functor to use for comparison.
+ * @params threads The number of threads to use, 0 for one per hardware
+ *                 thread.
+ * @return Nothing.
+ *
+ * Same as the executor overload, with a thread pool of @p threads threads
+ * created for the call.
+ */
+template <typename RandomIt, typename Compare>
+void
+parallel_stable_sort(RandomIt first, RandomIt last, Compare comp,
+                     unsigned threads = 0) {
+  if (last - first <= parallel_sort_cutoff || threads == 1) {
+    jnstl::stable_sort(first, last, comp);
+    return;
+  }
+
+  jnstl::parallel_executor executor(threads);
+  jnstl::parallel_stable_sort(executor, first, last, comp);
+}
+
+/**
+ * @brief Sorts the elements in the range [first, last) using several
+ * threads, preserving the order of equal elements.
+ * @ingroup sorting_algorithms
+ * @params first A random access iterator.
+ * @params last  A random access iterator.
+ * @return Nothing.
+ *
+ * Same as the other overloads, comparing the elements with operator < and
+ * using one thread per hardware thread.
+ */
+template <typename RandomIt>
+inline void
+parallel_stable_sort(RandomIt first, RandomIt last) {
+  std::less<typename jnstl::iterator_traits<RandomIt>::value_type> comp;
+  jnstl::parallel_stable_sort(first, last, comp);
+}
+
+}  // namespace jnstl
+
+#endif /* JNSTL_PARALLEL_ALGORITHM_H_ */
@@ -0,0 +1,262 @@
+#ifndef JNSTL_POOL_ALLOCATOR_H_
+#define JNSTL_POOL_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdlib>
+
+#include "JNSTL/bits/config.h"
+#include "JNSTL/allocator.h"
+
+namespace jnstl {
+/**
+ * @brief A size-class pool for fixed size allocations such as container nodes.
+ *
+ * Requests up to kMaxNodeSize bytes are rounded up to a multiple of
+ * kAlignment and served from the matching size class. Each class hands out
+ * nodes sequentially from its newest slab, so nodes inserted one after the
+ * other are laid out contiguously, and recycles freed nodes through an
+ * intrusive LIFO free list. Slabs are malloc'ed on demand, doubling in size
+ * up to kMaxSlabSize, and are only given back by release() or the destructor.
+ * Larger requests are forwarded to jnstl::allocator.
+ * The pool is not thread safe and not copyable, containers refer to it
+ * through pool_allocator.
+ */
+class node_pool {
+ public:
+  static const size_t kAlignment    = alignof(std::max_align_t);
+  static const size_t kMaxNodeSize  = 512;
+  static const size_t kClassCount   = kMaxNodeSize / kAlignment;
+  static const size_t kMinSlabNodes = 32;
+  static const size_t kMaxSlabSize  = 256 * 1024;
+
+  node_pool();
+  ~node_pool();
+
+  void* allocate(size_t n);
+  void* allocate(size_t n, size_t alignment, size_t offset);
+
+  void deallocate(void* p, size_t n);
+
+  /* Frees every slab. Containers still referring to the pool must be
+     cleared or destroyed before. */
+  void release();
+
+  size_t slab_count() const;
+
+ private:
+  struct FreeNode {
+    FreeNode* mNext;
+  };
+
+  struct Slab {
+    Slab* mNext;
+  };
+
+  struct SizeClass {
+    FreeNode* mFree;
+    char*     mCurrent;
+    char*     mEnd;
+    size_t    mSlabNodes;
+  };
+
+  /* Keeps the first node of a slab aligned to kAlignment */
+  static const size_t kSlabHeaderSize =
+      (sizeof(Slab) + kAlignment - 1) & ~(kAlignment - 1);
+
+  SizeClass mClasses[kClassCount];
+  Slab*     mSlabs;
+  size_t    mSlabCount;
+
+  static size_t sClassIndex(size_t n);
+
+  void  DoInit();
+  void* DoAllocateSlab(SizeClass& sc, size_t nodeSize);
+
+  node_pool(const node_pool&);
+  void operator=(const node_pool&);
+};
+
+/**
+ * @brief Allocator handle forwarding to a node_pool.
+ *
+ * Has the same interface as jnstl::allocator so it can be used as the
+ * Allocator parameter of list, map, set, multimap and multiset.
+ * Copies share the pool and compare equal. A default constructed
+ * pool_allocator has no pool and falls back to jnstl::allocator.
+ */
+class pool_allocator {
+ public:
+  pool_allocator();
+  pool_allocator(node_pool* pool);
+
+  void* allocate(size_t n);
+  void* allocate(size_t n, size_t alignment, size_t offset);
+
+  void deallocate(void* p, size_t n);
+
+  node_pool* get_pool() const;
+
+ private:
+  node_pool* mPool;
+};
+
+bool operator==(const pool_allocator& lhs, const pool_allocator& rhs);
+bool operator!=(const pool_allocator& lhs, const pool_allocator& rhs);
+
+// node_pool //
+
+inline node_pool::node_pool()
+    : mSlabs(nullptr),
+      mSlabCount(0) {
+  DoInit();
+}
+
+inline node_pool::~node_pool() {
+  release();
+}
+
+inline size_t node_pool::sClassIndex(size_t n) {
+  return (n - 1) / kAlignment;
+}
+
+inline void* node_pool::allocate(size_t n) {
+  if (n == 0)
+    return nullptr;
+
+  if (n > kMaxNodeSize)
+    return jnstl::allocator().allocate(n);
+
+  SizeClass& sc = mClasses[sClassIndex(n)];
+
+  if (sc.mFree != nullptr) {
+    FreeNode* const pNode = sc.mFree;
+    sc.mFree = pNode->mNext;
+    return pNode;
+  }
+
+  const size_t nodeSize = (sClassIndex(n) + 1) * kAlignment;
+
+  if (sc.mCurrent != sc.mEnd) {
+    void* const p = sc.mCurrent;
+    sc.mCurrent += nodeSize;
+    return p;
+  }
+
+  return DoAllocateSlab(sc, nodeSize);
+}
+
+/* Nodes are only aligned to kAlignment, stronger alignments are not
+   supported by the pool. An alignment of 0 means kAlignment. */
+inline void* node_pool::allocate(size_t n, size_t alignment, size_t offset) {
+  if (alignment == 0)
+    alignment = kAlignment;
+
+  if (alignment <= kAlignment && (offset % alignment) == 0)
+    return allocate(n);
+  return nullptr;
+}
+
+inline void node_pool::deallocate(void* p, size_t n) {
+  if (p == nullptr)
+    return;
+
+  if (n > kMaxNodeSize) {
+    jnstl::allocator().deallocate(p, n);
+    return;
+  }
+
+  SizeClass& sc = mClasses[sClassIndex(n)];
+  FreeNode* const pNode = static_cast<FreeNode*>(p);
+
+  pNode->mNext = sc.mFree;
+  sc.mFree = pNode;
+}
+
+inline void node_pool::release() {
+  while (mSlabs != nullptr) {
+    Slab* const pNext = mSlabs->mNext;
+    ::free(mSlabs);
+    mSlabs = pNext;
+  }
+  mSlabCount = 0;
+  DoInit();
+}
+
+inline size_t node_pool::slab_count() const {
+  return mSlabCount;
+}
+
+inline void node_pool::DoInit() {
+  for (size_t i = 0; i < kClassCount; ++i) {
+    mClasses[i].mFree      = nullptr;
+    mClasses[i].mCurrent   = nullptr;
+    mClasses[i].mEnd       = nullptr;
+    mClasses[i].mSlabNodes = kMinSlabNodes;
+  }
+}
+
+inline void* node_pool::DoAllocateSlab(SizeClass& sc, size_t nodeSize) {
+  const size_t size = kSlabHeaderSize + sc.mSlabNodes * nodeSize;
+
+  Slab* const pSlab = static_cast<Slab*>(::malloc(size));
+  if (pSlab == nullptr)
+    return nullptr;
+
+  pSlab->mNext = mSlabs;
+  mSlabs = pSlab;
+  ++mSlabCount;
+
+  /* Nodes are handed out in address order from the new slab. */
+  char* const pFirst = reinterpret_cast<char*>(pSlab) + kSlabHeaderSize;
+  sc.mCurrent = pFirst + nodeSize;
+  sc.mEnd     = pFirst + sc.mSlabNodes * nodeSize;
+
+  if (size * 2 <= kMaxSlabSize)
+    sc.mSlabNodes *= 2;
+
+  return pFirst;
+}
+
+// pool_allocator //
+
+inline pool_allocator::pool_allocator()
+    : mPool(nullptr) {}
+
+inline pool_allocator::pool_allocator(node_pool* pool)
+    : mPool(pool) {}
+
+inline void* pool_allocator::allocate(size_t n) {
+  if (mPool != nullptr)
+    return mPool->allocate(n);
+  return jnstl::allocator().allocate(n);
+}
+
+inline void* pool_allocator::allocate(size_t n, size_t alignment,
+                                      size_t offset) {
+  if (mPool != nullptr)
+    return mPool->allocate(n, alignment, offset);
+  return jnstl::allocator().allocate(n, alignment, offset);
+}
+
+inline void pool_allocator::deallocate(void* p, size_t n) {
+  if (mPool != nullptr)
+    mPool->deallocate(p, n);
+  else
+    jnstl::allocator().deallocate(p, n);
+}
+
+inline node_pool* pool_allocator::get_pool() const {
+  return mPool;
+}
+
+inline bool operator==(const pool_allocator& lhs, const pool_allocator& rhs) {
+  return lhs.get_pool() == rhs.get_pool();
+}
+
+inline bool operator!=(const pool_allocator& lhs, const pool_allocator& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace jnstl
+
+#endif /* JNSTL_POOL_ALLOCATOR_H_ */
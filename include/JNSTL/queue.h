@@ -1,7 +1,13 @@
 #ifndef JNSTL_QUEUE_H_
 #define JNSTL_QUEUE_H_
 
+#include <stdint.h>
+
+#include <limits>
+#include <type_traits>
+
 #include "JNSTL/bits/config.h"
+#include "JNSTL/deque.h"
 
 namespace jnstl {
 /**
@@ -26,7 +32,7 @@ namespace jnstl {
  * pop_front()
  * The containers deque and list satisfy these requirements.
  */
-template <typename T, typename Container = jnstl::list<T>>
+template <typename T, typename Container = jnstl::deque<T>>
 class queue {
   template <typename T1, typename C1>
   friend bool
@@ -197,6 +203,8 @@ swap(queue<T, Container>& lhs, queue<T, Container>& rhs) {
  * @tparam Container The type of the underlyng container used to store the
  * elements.
  * @tparam Compare A compare function providing a strict weak ordering.
+ * @tparam Arity The number of children of a node of the heap. Queues of
+ * millions of elements pop faster with 4 or 8, see pop_heap<Arity>.
  *
  * The type of the underlying container to use to store the elements must
  * satisfy the requirements of SequenceContainer and its iterators must satisfy
@@ -208,10 +216,11 @@ swap(queue<T, Container>& lhs, queue<T, Container>& rhs) {
  * The containers vector and deque satisfy these requirements.
  */
 template <typename T, typename Container = jnstl::vector<T>,
-          typename Compare = std::less<typename Container::value_type>>
+          typename Compare = std::less<typename Container::value_type>,
+          size_t Arity = 2>
 class priority_queue {
  public:
-  typedef priority_queue<T, Container>           this_type;
+  typedef priority_queue<T, Container, Compare, Arity> this_type;
   typedef Container                              container_type;
   typedef Compare                                compare_type;
   typedef typename Container::value_type         value_type;
@@ -228,14 +237,14 @@ class priority_queue {
   explicit
   priority_queue(const compare_type& compare, const container_type& cont)
       : c{cont}, comp{compare} {
-    jnstl::make_heap(c.begin(), c.end(), comp);
+    jnstl::make_heap<Arity>(c.begin(), c.end(), comp);
   }
 
   explicit
   priority_queue(const compare_type& compare = Compare(),
                  container_type&& cont = container_type())
       : c{LIB::move(cont)}, comp{compare} {
-    jnstl::make_heap(c.begin(), c.end(), comp);
+    jnstl::make_heap<Arity>(c.begin(), c.end(), comp);
   }
 
   template<typename InputIt>
@@ -243,7 +252,7 @@ class priority_queue {
                  const Container& cont)
       : c{cont}, comp{compare} {
     c.insert(c.end(), first, last);
-    jnstl::make_heap(c.begin(), c.end(), comp);
+    jnstl::make_heap<Arity>(c.begin(), c.end(), comp);
   }
 
   template<typename InputIt>
@@ -252,7 +261,7 @@ class priority_queue {
                  Container&& cont = Container())
       : c{LIB::move(cont)}, comp{compare} {
     c.insert(c.end(), first, last);
-    jnstl::make_heap(c.begin(), c.end(), comp);
+    jnstl::make_heap<Arity>(c.begin(), c.end(), comp);
   }
 
   /**
@@ -287,13 +296,35 @@ class priority_queue {
   void
   push(const value_type& value) {
     c.push_back(value);
-    jnstl::push_heap(c.begin(), c.end(), comp);
+    jnstl::push_heap<Arity>(c.begin(), c.end(), comp);
   }
 
   void
   push(value_type&& value) {
     c.push_back(LIB::move(value));
-    jnstl::push_heap(c.begin(), c.end(), comp);
+    jnstl::push_heap<Arity>(c.begin(), c.end(), comp);
+  }
+
+  /**
+   *  @brief Pushes the elements of the range [first, last).
+   *
+   *  The elements are appended to the container, then either promoted one
+   *  by one or, if there are at least as many as already queued, the whole
+   *  heap is rebuilt. Iterators with std iterator tags are appended one by
+   *  one with push_back.
+   */
+  template <typename InputIt>
+  void
+  push_range(InputIt first, InputIt last) {
+    typedef typename jnstl::iterator_traits<InputIt>::iterator_category IC;
+    typedef std::integral_constant<bool,
+        std::is_convertible<IC, jnstl::input_iterator_tag>::value> IsJnstl;
+
+    const size_type oldSize = c.size();
+
+    DoAppend(first, last, IsJnstl());
+    jnstl::heap_push_range<Arity>(c.begin(), c.begin() + oldSize, c.end(),
+                                  comp);
   }
 
   /**
@@ -305,7 +336,7 @@ class priority_queue {
    */
   void
   pop() {
-    std::pop_heap(c.begin(), c.end(), comp);
+    jnstl::pop_heap<Arity>(c.begin(), c.end(), comp);
     c.pop_back();
   }
 
@@ -326,14 +357,550 @@ class priority_queue {
 
   bool
   validate() const {
-    return c.validate() && jnstl::is_heap(c.begin(), c.end(), comp);
+    return c.validate() && jnstl::is_heap<Arity>(c.begin(), c.end(), comp);
+  }
+
+ private:
+  template <typename InputIt>
+  void
+  DoAppend(InputIt first, InputIt last, std::true_type) {
+    c.insert(c.end(), first, last);
+  }
+
+  template <typename InputIt>
+  void
+  DoAppend(InputIt first, InputIt last, std::false_type) {
+    for (; first != last; ++first)
+      c.push_back(*first);
   }
 };  // priority_queue
 
-template <typename T, typename Container, typename Compare>
+template <typename T, typename Container, typename Compare, size_t Arity>
+inline void
+swap(priority_queue<T, Container, Compare, Arity>& lhs,
+     priority_queue<T, Container, Compare, Arity>& rhs) {
+  lhs.swap(rhs);
+}
+
+/**
+ * @brief A priority queue whose elements can be changed or removed while in
+ * the queue, through the handle returned when pushing them.
+ *
+ * @tparam T Type of the stored elements.
+ * @tparam Compare A compare function providing a strict weak ordering.
+ * @tparam Arity The number of children of a node of the heap.
+ *
+ * The elements are kept in a heap next to their handle, and a position map
+ * gives the index in the heap of every handle. The sift functions of the
+ * heap algorithms maintain the map as they move elements, through an
+ * iterator whose writes also record the new position of the element.
+ * update, decrease_key and erase are then O(log n), instead of pushing
+ * duplicates and skipping the stale ones as they come out.
+ * A handle stays valid until its element is popped or erased, after which
+ * it can be given to a new element.
+ */
+template <typename T, typename Compare = std::less<T>, size_t Arity = 2>
+class indexed_priority_queue {
+ public:
+  typedef indexed_priority_queue<T, Compare, Arity> this_type;
+  typedef T                                         value_type;
+  typedef const T&                                  const_reference;
+  typedef Compare                                   compare_type;
+  typedef size_t                                    size_type;
+  typedef size_t                                    handle_type;
+
+ private:
+  struct node {
+    T           mValue;
+    handle_type mHandle;
+  };
+
+  struct node_compare {
+    Compare mComp;
+
+    bool operator()(const node& a, const node& b) const {
+      return mComp(a.mValue, b.mValue);
+    }
+  };
+
+  /* Reference to a slot of the heap, assigning a node to it records the
+     position of the node's handle */
+  class slot_ref {
+   public:
+    slot_ref(this_type& queue, size_type idx)
+        : mQueue(queue), mIdx(idx) {}
+
+    slot_ref(const slot_ref&) = default;
+
+    operator const node&() const {
+      return mQueue.mHeap[mIdx];
+    }
+
+    slot_ref& operator=(node&& x) {
+      mQueue.mPos[x.mHandle] = mIdx;
+      mQueue.mHeap[mIdx] = LIB::move(x);
+      return *this;
+    }
+
+    slot_ref& operator=(slot_ref&& other) {
+      return *this = LIB::move(other.mQueue.mHeap[other.mIdx]);
+    }
+
+   private:
+    this_type& mQueue;
+    size_type  mIdx;
+  };
+
+  /* The part of a random access iterator the sift functions use */
+  class slot_iterator {
+   public:
+    typedef random_access_iterator_tag iterator_category;
+    typedef node                       value_type;
+    typedef ptrdiff_t                  difference_type;
+    typedef void                       pointer;
+    typedef slot_ref                   reference;
+
+    slot_iterator(this_type& queue, size_type idx)
+        : mQueue(&queue), mIdx(idx) {}
+
+    reference operator*() const {
+      return slot_ref(*mQueue, mIdx);
+    }
+
+    slot_iterator operator+(difference_type n) const {
+      return slot_iterator(*mQueue, mIdx + n);
+    }
+
+   private:
+    this_type* mQueue;
+    size_type  mIdx;
+  };
+
+  /* Position of the handles not in use */
+  static const size_type kFree = size_type(-1);
+
+  jnstl::vector<node>        mHeap;
+  jnstl::vector<size_type>   mPos;
+  jnstl::vector<handle_type> mFree;
+  node_compare               mComp;
+
+ public:
+  explicit
+  indexed_priority_queue(const compare_type& compare = Compare())
+      : mComp{compare} {}
+
+  /**
+   *  Checks if the queue has no elements.
+   */
+  bool
+  empty() const {
+    return mHeap.empty();
+  }
+
+  /**
+   * Returns the number of elements in the queue.
+   */
+  size_type
+  size() const {
+    return mHeap.size();
+  }
+
+  /**
+   * Returns a read-only reference to the first element of the queue, the
+   * greatest one if the default comparison function is used.
+   */
+  const_reference
+  top() const {
+    return mHeap.front().mValue;
+  }
+
+  /**
+   * Returns the handle of the first element of the queue.
+   */
+  handle_type
+  top_handle() const {
+    return mHeap.front().mHandle;
+  }
+
+  /**
+   * Checks if the element of the handle is in the queue.
+   */
+  bool
+  contains(handle_type handle) const {
+    return handle < mPos.size() && mPos[handle] != kFree;
+  }
+
+  /**
+   * Returns a read-only reference to the element of the handle.
+   */
+  const_reference
+  operator[](handle_type handle) const {
+    return mHeap[mPos[handle]].mValue;
+  }
+
+  /**
+   *   Pushes the given element to the queue.
+   *   @return The handle of the element.
+   */
+  handle_type
+  push(const value_type& value) {
+    return DoPush(value_type(value));
+  }
+
+  handle_type
+  push(value_type&& value) {
+    return DoPush(LIB::move(value));
+  }
+
+  /**
+   *  @brief Removes the top element from the queue.
+   *
+   *  Its handle can be given to the next pushed element.
+   */
+  void
+  pop() {
+    DoErase(0);
+  }
+
+  /**
+   *  @brief Removes the element of the handle from the queue.
+   */
+  void
+  erase(handle_type handle) {
+    DoErase(mPos[handle]);
+  }
+
+  /**
+   *  @brief Replaces the element of the handle, which moves towards the top
+   *  or the bottom of the queue depending on the new value.
+   */
+  void
+  update(handle_type handle, const value_type& value) {
+    DoUpdate(handle, value_type(value));
+  }
+
+  void
+  update(handle_type handle, value_type&& value) {
+    DoUpdate(handle, LIB::move(value));
+  }
+
+  /**
+   *  @brief Replaces the element of the handle by one that does not come
+   *  later out of the queue, which only has to move it towards the top.
+   *
+   *  This is the decrease-key of the algorithms using a min-queue, as with
+   *  Compare = std::greater: the new key must not compare greater than the
+   *  current one (or, with the default std::less, not less).
+   */
+  void
+  decrease_key(handle_type handle, const value_type& value) {
+    DoPromote(mPos[handle], node{value, handle});
+  }
+
+  void
+  decrease_key(handle_type handle, value_type&& value) {
+    DoPromote(mPos[handle], node{LIB::move(value), handle});
+  }
+
+  /**
+   * Exchanges the contents of the queue with those of other.
+   */
+  void
+  swap(indexed_priority_queue& other) {
+    using std::swap;
+    swap(mHeap, other.mHeap);
+    swap(mPos, other.mPos);
+    swap(mFree, other.mFree);
+    swap(mComp, other.mComp);
+  }
+
+  bool
+  validate() const {
+    for (size_type i = 0; i < mHeap.size(); ++i) {
+      if (mPos[mHeap[i].mHandle] != i)
+        return false;
+    }
+    return mHeap.validate() &&
+           jnstl::is_heap<Arity>(mHeap.begin(), mHeap.end(), mComp);
+  }
+
+ private:
+  slot_iterator
+  DoSlots() {
+    return slot_iterator(*this, 0);
+  }
+
+  handle_type
+  DoPush(value_type&& value) {
+    handle_type handle;
+
+    if (mFree.empty()) {
+      handle = mPos.size();
+      mPos.push_back(kFree);
+    } else {
+      handle = mFree.back();
+      mFree.pop_back();
+    }
+    mHeap.push_back(node{LIB::move(value), handle});
+    DoPromote(mHeap.size() - 1, LIB::move(mHeap.back()));
+    return handle;
+  }
+
+  void
+  DoPromote(size_type idx, node&& x) {
+    jnstl::dary_heap<Arity>::promote(DoSlots(), ptrdiff_t(idx), ptrdiff_t(0),
+                                     LIB::move(x), mComp);
+  }
+
+  /* Puts x in the slot at idx, and from there where it belongs */
+  void
+  DoPlace(size_type idx, node&& x) {
+    if (idx > 0 && mComp(mHeap[(idx - 1) / Arity], x))
+      DoPromote(idx, LIB::move(x));
+    else
+      jnstl::dary_heap<Arity>::adjust(DoSlots(), ptrdiff_t(idx),
+                                      ptrdiff_t(mHeap.size()), LIB::move(x),
+                                      mComp);
+  }
+
+  void
+  DoUpdate(handle_type handle, value_type&& value) {
+    DoPlace(mPos[handle], node{LIB::move(value), handle});
+  }
+
+  void
+  DoErase(size_type idx) {
+    const handle_type handle = mHeap[idx].mHandle;
+    node last = LIB::move(mHeap.back());
+
+    mHeap.pop_back();
+    if (idx < mHeap.size())
+      DoPlace(idx, LIB::move(last));
+    mPos[handle] = kFree;
+    mFree.push_back(handle);
+  }
+};  // indexed_priority_queue
+
+template <typename T, typename Compare, size_t Arity>
+const typename indexed_priority_queue<T, Compare, Arity>::size_type
+    indexed_priority_queue<T, Compare, Arity>::kFree;
+
+template <typename T, typename Compare, size_t Arity>
+inline void
+swap(indexed_priority_queue<T, Compare, Arity>& lhs,
+     indexed_priority_queue<T, Compare, Arity>& rhs) {
+  lhs.swap(rhs);
+}
+
+/* Number of significant bits of x, 0 for 0 */
+inline int
+radix_heap_bit_width(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return x ? 64 - __builtin_clzll(x) : 0;
+#else
+  int width = 0;
+  for (; x != 0; x >>= 1)
+    ++width;
+  return width;
+#endif
+}
+
+/* Index of the lowest set bit of x, which is not 0 */
+inline int
+radix_heap_lowest_bit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(x);
+#else
+  int i = 0;
+  for (; (x & 1) == 0; x >>= 1)
+    ++i;
+  return i;
+#endif
+}
+
+/* Key of the elements of a radix_heap holding the keys themselves */
+template <typename T>
+struct radix_heap_identity {
+  const T& operator()(const T& x) const {
+    return x;
+  }
+};
+
+/**
+ * @brief A monotone priority queue of unsigned integer keys: the smallest
+ * element comes out first, and no key pushed is smaller than the last one
+ * returned by top().
+ *
+ * @tparam T Type of the stored elements.
+ * @tparam KeyOf A function giving the key of an element, of an unsigned
+ * integral type. Fixed point values use their integral representation.
+ *
+ * The elements are spread over one bucket per bit of the key, plus one:
+ * bucket 0 holds the keys equal to the last key returned by top(), bucket i
+ * the keys whose highest bit differing from it is bit i - 1. When bucket 0
+ * runs out, the first non-empty bucket is scanned for its minimum, which
+ * becomes the new last key, and its elements are redistributed to lower
+ * buckets. As an element only moves down, it moves at most once per bit of
+ * the key: push is O(1) and pop amortized O(log C) for keys up to C, with
+ * sequential scans of the buckets and no comparison between elements.
+ * top() may have to redistribute a bucket, which does not change the
+ * content of the queue: the buckets are mutable.
+ */
+template <typename T, typename KeyOf = radix_heap_identity<T>>
+class radix_heap {
+ public:
+  typedef radix_heap<T, KeyOf>                    this_type;
+  typedef T                                       value_type;
+  typedef const T&                                const_reference;
+  typedef size_t                                  size_type;
+  typedef typename std::decay<decltype(LIB::declval<const KeyOf&>()(
+      LIB::declval<const T&>()))>::type           key_type;
+
+  static_assert(std::is_unsigned<key_type>::value &&
+                std::numeric_limits<key_type>::digits <= 64,
+                "radix_heap keys must be unsigned integers of up to 64 bits");
+
+ private:
+  static const int kBuckets = std::numeric_limits<key_type>::digits + 1;
+
+  mutable jnstl::vector<T> mBuckets[kBuckets];
+  /* Bit i - 1 is set when bucket i is not empty */
+  mutable uint64_t         mNonEmpty;
+  mutable key_type         mLast;
+  size_type                mSize;
+  KeyOf                    mKeyOf;
+
+ public:
+  explicit
+  radix_heap(const KeyOf& keyOf = KeyOf())
+      : mNonEmpty(0), mLast(0), mSize(0), mKeyOf(keyOf) {}
+
+  /**
+   *  Checks if the queue has no elements.
+   */
+  bool
+  empty() const {
+    return mSize == 0;
+  }
+
+  /**
+   * Returns the number of elements in the queue.
+   */
+  size_type
+  size() const {
+    return mSize;
+  }
+
+  /**
+   * Returns a read-only reference to the element of smallest key.
+   */
+  const_reference
+  top() const {
+    DoPull();
+    return mBuckets[0].back();
+  }
+
+  /**
+   *   Pushes the given element, whose key must not be smaller than the key
+   *   of the last top().
+   */
+  void
+  push(const value_type& value) {
+    DoBucketOf(mKeyOf(value)).push_back(value);
+    ++mSize;
+  }
+
+  void
+  push(value_type&& value) {
+    DoBucketOf(mKeyOf(value)).push_back(LIB::move(value));
+    ++mSize;
+  }
+
+  /**
+   *  @brief Removes the element of smallest key.
+   */
+  void
+  pop() {
+    DoPull();
+    mBuckets[0].pop_back();
+    --mSize;
+  }
+
+  /**
+   * Exchanges the contents of the queue with those of other.
+   */
+  void
+  swap(radix_heap& other) {
+    using std::swap;
+    for (int i = 0; i < kBuckets; ++i)
+      swap(mBuckets[i], other.mBuckets[i]);
+    swap(mNonEmpty, other.mNonEmpty);
+    swap(mLast, other.mLast);
+    swap(mSize, other.mSize);
+    swap(mKeyOf, other.mKeyOf);
+  }
+
+  bool
+  validate() const {
+    size_type size = 0;
+
+    for (int i = 0; i < kBuckets; ++i) {
+      const jnstl::vector<T>& bucket = mBuckets[i];
+
+      if (i > 0 && bucket.empty() == ((mNonEmpty >> (i - 1)) & 1))
+        return false;
+      for (size_type j = 0; j < bucket.size(); ++j) {
+        if (sIndex(mKeyOf(bucket[j]), mLast) != i)
+          return false;
+      }
+      size += bucket.size();
+    }
+    return size == mSize;
+  }
+
+ private:
+  /* Index of the bucket of key */
+  static int
+  sIndex(key_type key, key_type last) {
+    return jnstl::radix_heap_bit_width(uint64_t(key ^ last));
+  }
+
+  jnstl::vector<T>&
+  DoBucketOf(key_type key) const {
+    const int i = sIndex(key, mLast);
+
+    if (i > 0)
+      mNonEmpty |= uint64_t(1) << (i - 1);
+    return mBuckets[i];
+  }
+
+  /* Refills bucket 0 from the first non-empty bucket */
+  void
+  DoPull() const {
+    if (!mBuckets[0].empty())
+      return;
+
+    const int i = jnstl::radix_heap_lowest_bit(mNonEmpty) + 1;
+    jnstl::vector<T>& bucket = mBuckets[i];
+    key_type last = mKeyOf(bucket[0]);
+
+    for (size_type j = 1; j < bucket.size(); ++j) {
+      const key_type key = mKeyOf(bucket[j]);
+      if (key < last)
+        last = key;
+    }
+    mLast = last;
+
+    mNonEmpty &= ~(uint64_t(1) << (i - 1));
+    for (size_type j = 0; j < bucket.size(); ++j)
+      DoBucketOf(mKeyOf(bucket[j])).push_back(LIB::move(bucket[j]));
+    bucket.clear();
+  }
+};  // radix_heap
+
+template <typename T, typename KeyOf>
 inline void
-swap(priority_queue<T, Container, Compare>& lhs,
-     priority_queue<T, Container, Compare>& rhs) {
+swap(radix_heap<T, KeyOf>& lhs, radix_heap<T, KeyOf>& rhs) {
   lhs.swap(rhs);
 }
 
@@ -21,6 +21,14 @@ enum rbtree_color {
   mBlack
 };
 
+// Tells a range constructor or insert that the input is already sorted by
+// the container's comparator, without duplicate keys for sorted_unique.
+struct sorted_unique_t {};
+struct sorted_equivalent_t {};
+
+const sorted_unique_t     sorted_unique     = sorted_unique_t();
+const sorted_equivalent_t sorted_equivalent = sorted_equivalent_t();
+
 struct rbtree_node_base {
   typedef       rbtree_node_base          node_base_type;
   typedef const rbtree_node_base    const_node_base_type;
@@ -322,22 +330,83 @@ class rbtree {
   pair<      iterator,       iterator> equal_range(const key_type& key);
   pair<const_iterator, const_iterator> equal_range(const key_type& key) const;
 
+  // Heterogeneous lookup, only available when Compare defines
+  // is_transparent (e.g. std::less<>): x is compared to the keys as is,
+  // without being converted to key_type.
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+        iterator find(const K& x);
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  const_iterator find(const K& x) const;
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+        iterator lower_bound(const K& x);
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  const_iterator lower_bound(const K& x) const;
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+        iterator upper_bound(const K& x);
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  const_iterator upper_bound(const K& x) const;
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  pair<      iterator,       iterator> equal_range(const K& key);
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  pair<const_iterator, const_iterator> equal_range(const K& key) const;
+
   bool validate() const;
   bool validate_iterator(const_iterator i) const;
 
   pair<iterator, bool> DoInsertUnique(const value_type& value);
+  pair<iterator, bool> DoInsertUnique(value_type&& value);
               iterator DoInsertUnique(const_iterator position,
                                       const value_type& value);
+              iterator DoInsertUnique(const_iterator position,
+                                      value_type&& value);
 
   template<typename InputIterator>
   void DoInsertUnique(InputIterator first, InputIterator last);
 
+  // Constructs the value from args only if key is not in the tree yet.
+  template <typename... Args>
+  pair<iterator, bool> DoInsertUniqueKey(const key_type& key,
+                                         Args&&... args);
+  template <typename... Args>
+              iterator DoInsertUniqueKey(const_iterator position,
+                                         const key_type& key,
+                                         Args&&... args);
+
+  template <typename... Args>
+  pair<iterator, bool> DoEmplaceUnique(Args&&... args);
+  template <typename... Args>
+              iterator DoEmplaceUniqueHint(const_iterator position,
+                                           Args&&... args);
+
   iterator DoInsertMulti(const value_type& value);
+  iterator DoInsertMulti(value_type&& value);
   iterator DoInsertMulti(const_iterator position, const value_type& value);
+  iterator DoInsertMulti(const_iterator position, value_type&& value);
 
   template<typename InputIterator>
   void DoInsertMulti(InputIterator first, InputIterator last);
 
+  template <typename... Args>
+  iterator DoEmplaceMulti(Args&&... args);
+  template <typename... Args>
+  iterator DoEmplaceMultiHint(const_iterator position, Args&&... args);
+
+  // Inserts a range known to be sorted. Builds the tree in O(n) when
+  // empty, otherwise inserts each element next to the previous one.
+  template<typename InputIterator>
+  void DoInsertSorted(InputIterator first, InputIterator last, bool unique);
+
   template<typename InputIterator>
   void DoAssignUnique(InputIterator first, InputIterator last);
 
@@ -391,36 +460,53 @@ class rbtree {
   node_type* DoAllocateNode();
   void       DoFreeNode(node_type* pNode);
 
-  node_type* DoCreateNode(const value_type& value);
+  template <typename... Args>
+  node_type* DoCreateNode(Args&&... args);
   node_type* DoCreateNode(const node_type* pSource, node_type* pParent);
   void       DoDestroyNode(node_type* pNode);
 
   node_type* DoCreateTree(const node_type* pSource, node_type* pParent);
   void       DoDestroyTree(node_type* pTop);
 
+  template <typename K>
+  iterator DoFind(const K& key);
+  template <typename K>
+  const_iterator DoFind(const K& key) const;
+
+  template <typename K>
+  pair<iterator, iterator> DoEqualRange(const K& key);
+  template <typename K>
+  pair<const_iterator, const_iterator> DoEqualRange(const K& key) const;
+
+  template <typename K>
   node_base_type*
-  FindEqual(node_base_type_ptr& pPparent, const key_type& key);
+  FindEqual(node_base_type_ptr& pPparent, const K& key);
 
   node_base_type*
   FindMulti(node_base_type_ptr& pParent, const key_type& key);
 
+  template <typename K>
   node_base_type*
   FindEqual(const_iterator position, node_base_type_ptr& pParent,
-            node_base_type_ptr& dummy, const key_type& key);
+            node_base_type_ptr& dummy, const K& key);
 
+  template <typename K>
   iterator
-  LowerBound(node_type* first, node_type* last, const key_type& key);
+  LowerBound(node_type* first, node_type* last, const K& key);
 
+  template <typename K>
   const_iterator
   LowerBound(const node_type* first, const node_type* last,
-             const key_type& key) const;
+             const K& key) const;
 
+  template <typename K>
   iterator
-  UpperBound(node_type* first, node_type* last, const key_type& key);
+  UpperBound(node_type* first, node_type* last, const K& key);
 
+  template <typename K>
   const_iterator
   UpperBound(const node_type* first, const node_type* last,
-             const key_type& key) const;
+             const K& key) const;
 
   node_base_type*
   FindLeafLow(node_base_type_ptr& pParent, const key_type& key);
@@ -429,9 +515,40 @@ class rbtree {
   FindLeaf(const_iterator position, node_base_type_ptr& pParent,
            const key_type& key);
 
+  template <typename... Args>
+  iterator
+  DoInsert(node_base_type* pParent, node_base_type* pChild, Args&&... args);
+
   iterator
-  DoInsert(node_base_type* pParent, node_base_type* pChild,
-           const value_type& value);
+  DoInsertNode(node_base_type* pParent, node_base_type* pChild,
+               node_type* pNew);
+
+  template <typename InputIterator>
+  void DoInsertRange(InputIterator first, InputIterator last, bool unique,
+                     std::true_type);
+  template <typename InputIterator>
+  void DoInsertRange(InputIterator first, InputIterator last, bool unique,
+                     std::false_type);
+  template <typename InputIterator>
+  void DoInsertHinted(InputIterator first, InputIterator last, bool unique);
+
+  template <typename ForwardIterator>
+  bool DoCountSorted(ForwardIterator first, ForwardIterator last,
+                     bool unique, size_type& n) const;
+  template <typename ForwardIterator>
+  size_type DoCount(ForwardIterator first, ForwardIterator last,
+                    bool unique) const;
+  template <typename ForwardIterator>
+  void DoNextSorted(ForwardIterator& first, ForwardIterator last,
+                    bool unique) const;
+
+  template <typename ForwardIterator>
+  void DoBuildSorted(ForwardIterator first, ForwardIterator last,
+                     size_type n, bool unique);
+  template <typename ForwardIterator>
+  node_type* DoBuildSortedTree(ForwardIterator& first, ForwardIterator last,
+                               size_type n, size_type depth,
+                               size_type redDepth, bool unique);
 
   void DoSwap(this_type& x);
 
@@ -772,9 +889,41 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::clear() {
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
-typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+inline typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
 rbtree<Key, T, KeyOfT, Compare, Allocator>::find(
     const key_type& key) {
+  return DoFind(key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+inline typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::find(
+    const key_type& key) const {
+  return DoFind(key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename K, typename C, typename>
+inline typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::find(const K& key) {
+  return DoFind(key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename K, typename C, typename>
+inline typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::find(const K& key) const {
+  return DoFind(key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename K>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoFind(const K& key) {
   iterator x = LowerBound(mBegin(), mEnd(), key);
 
   if (x == end() || mImpl.KeyCompare(key, sKey(x.mNode)))
@@ -785,9 +934,9 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::find(
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
+template <typename K>
 typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator
-rbtree<Key, T, KeyOfT, Compare, Allocator>::find(
-    const key_type& key) const {
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoFind(const K& key) const {
   const_iterator x = LowerBound(mBegin(), mEnd(), key);
 
   if (x == end() || mImpl.KeyCompare(key, sKey(x.mNode)))
@@ -830,10 +979,80 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::upper_bound(
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
-pair<typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator,
-     typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator>
+template <typename K, typename C, typename>
+inline typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::lower_bound(const K& key) {
+  return LowerBound(mBegin(), mEnd(), key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename K, typename C, typename>
+inline typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::lower_bound(const K& key) const {
+  return LowerBound(mBegin(), mEnd(), key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename K, typename C, typename>
+inline typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::upper_bound(const K& key) {
+  return UpperBound(mBegin(), mEnd(), key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename K, typename C, typename>
+inline typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::upper_bound(const K& key) const {
+  return UpperBound(mBegin(), mEnd(), key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+inline pair<typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator,
+            typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator>
 rbtree<Key, T, KeyOfT, Compare, Allocator>::equal_range(
     const key_type& key) {
+  return DoEqualRange(key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+inline
+pair<typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator,
+     typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator>
+rbtree<Key, T, KeyOfT, Compare, Allocator>::equal_range(
+    const key_type& key) const {
+  return DoEqualRange(key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename K, typename C, typename>
+inline pair<typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator,
+            typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator>
+rbtree<Key, T, KeyOfT, Compare, Allocator>::equal_range(const K& key) {
+  return DoEqualRange(key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename K, typename C, typename>
+inline
+pair<typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator,
+     typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator>
+rbtree<Key, T, KeyOfT, Compare, Allocator>::equal_range(const K& key) const {
+  return DoEqualRange(key);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename K>
+pair<typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator,
+     typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator>
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoEqualRange(const K& key) {
   node_type* x = mBegin();
   node_type* y = mEnd();
 
@@ -859,10 +1078,11 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::equal_range(
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
+template <typename K>
 pair<typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator,
      typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator>
-rbtree<Key, T, KeyOfT, Compare, Allocator>::equal_range(
-    const key_type& key) const {
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoEqualRange(
+    const K& key) const {
   const_node_type* x = mBegin();
   const_node_type* y = mEnd();
 
@@ -1014,15 +1234,124 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertUnique(
   return it;
 }
 
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+pair<typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator, bool>
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertUnique(
+    value_type&& value) {
+  node_base_type_ptr parent;
+  node_base_type* child = FindEqual(parent, KeyOfT()(value));
+
+  if (child != nullptr)
+    return pair<iterator, bool>(iterator(static_cast<node_type*>(child)),
+                                false);
+
+  return pair<iterator, bool>(DoInsert(parent, child, LIB::move(value)),
+                              true);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertUnique(
+    const_iterator position, value_type&& value) {
+  node_base_type_ptr parent;
+  node_base_type_ptr dummy;
+  node_base_type* child = FindEqual(position, parent, dummy,
+                                    KeyOfT()(value));
+
+  if (child != nullptr)
+    return iterator(static_cast<node_type*>(child));
+
+  return DoInsert(parent, child, LIB::move(value));
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename... Args>
+pair<typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator, bool>
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertUniqueKey(
+    const key_type& key, Args&&... args) {
+  node_base_type_ptr parent;
+  node_base_type* child = FindEqual(parent, key);
+
+  if (child != nullptr)
+    return pair<iterator, bool>(iterator(static_cast<node_type*>(child)),
+                                false);
+
+  return pair<iterator, bool>(
+      DoInsert(parent, child, LIB::forward<Args>(args)...), true);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename... Args>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertUniqueKey(
+    const_iterator position, const key_type& key, Args&&... args) {
+  node_base_type_ptr parent;
+  node_base_type_ptr dummy;
+  node_base_type* child = FindEqual(position, parent, dummy, key);
+
+  if (child != nullptr)
+    return iterator(static_cast<node_type*>(child));
+
+  return DoInsert(parent, child, LIB::forward<Args>(args)...);
+}
+
+// The key is only known once the value is built, so the node is created
+// first and destroyed again if the key is already present.
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename... Args>
+pair<typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator, bool>
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoEmplaceUnique(
+    Args&&... args) {
+  node_type* const pNew = DoCreateNode(LIB::forward<Args>(args)...);
+  node_base_type_ptr parent;
+  node_base_type* child = FindEqual(parent, sKey(pNew));
+
+  if (child != nullptr) {
+    DoDestroyNode(pNew);
+    return pair<iterator, bool>(iterator(static_cast<node_type*>(child)),
+                                false);
+  }
+
+  return pair<iterator, bool>(DoInsertNode(parent, child, pNew), true);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename... Args>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoEmplaceUniqueHint(
+    const_iterator position, Args&&... args) {
+  node_type* const pNew = DoCreateNode(LIB::forward<Args>(args)...);
+  node_base_type_ptr parent;
+  node_base_type_ptr dummy;
+  node_base_type* child = FindEqual(position, parent, dummy, sKey(pNew));
+
+  if (child != nullptr) {
+    DoDestroyNode(pNew);
+    return iterator(static_cast<node_type*>(child));
+  }
+
+  return DoInsertNode(parent, child, pNew);
+}
+
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
 template<typename InputIterator>
-void
+inline void
 rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertUnique(
     InputIterator first, InputIterator last) {
-  for (; first != last; ++first)
-    DoInsertUnique(end(), *first);
-  // DoInsertUnique(*first);
+  typedef typename
+      jnstl::iterator_traits<InputIterator>::iterator_category IC;
+  typedef std::integral_constant<bool,
+      std::is_convertible<IC, jnstl::forward_iterator_tag>::value ||
+      std::is_convertible<IC, std::forward_iterator_tag>::value> IsForward;
+
+  DoInsertRange(first, last, true, IsForward());
 }
 
 template <typename Key, typename T, typename KeyOfT,
@@ -1047,14 +1376,84 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertMulti(
   return iterator(DoInsert(parent, child, value));
 }
 
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertMulti(
+    value_type&& value) {
+  node_base_type_ptr parent;
+  node_base_type* child = FindMulti(parent, KeyOfT()(value));
+
+  return DoInsert(parent, child, LIB::move(value));
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertMulti(
+    const_iterator position, value_type&& value) {
+  node_base_type_ptr parent;
+  node_base_type* child = FindLeaf(position, parent, KeyOfT()(value));
+
+  return DoInsert(parent, child, LIB::move(value));
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename... Args>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoEmplaceMulti(Args&&... args) {
+  node_type* const pNew = DoCreateNode(LIB::forward<Args>(args)...);
+  node_base_type_ptr parent;
+  node_base_type* child = FindMulti(parent, sKey(pNew));
+
+  return DoInsertNode(parent, child, pNew);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename... Args>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoEmplaceMultiHint(
+    const_iterator position, Args&&... args) {
+  node_type* const pNew = DoCreateNode(LIB::forward<Args>(args)...);
+  node_base_type_ptr parent;
+  node_base_type* child = FindLeaf(position, parent, sKey(pNew));
+
+  return DoInsertNode(parent, child, pNew);
+}
+
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
 template<typename InputIterator>
-void
+inline void
 rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertMulti(
     InputIterator first, InputIterator last) {
-  for (; first != last; ++first)
-    DoInsertMulti(end(), *first);
+  typedef typename
+      jnstl::iterator_traits<InputIterator>::iterator_category IC;
+  typedef std::integral_constant<bool,
+      std::is_convertible<IC, jnstl::forward_iterator_tag>::value ||
+      std::is_convertible<IC, std::forward_iterator_tag>::value> IsForward;
+
+  DoInsertRange(first, last, false, IsForward());
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template<typename InputIterator>
+void
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertSorted(
+    InputIterator first, InputIterator last, bool unique) {
+  typedef typename
+      jnstl::iterator_traits<InputIterator>::iterator_category IC;
+
+  if (empty() &&
+      (std::is_convertible<IC, jnstl::forward_iterator_tag>::value ||
+       std::is_convertible<IC, std::forward_iterator_tag>::value)) {
+    DoBuildSorted(first, last, DoCount(first, last, unique), unique);
+  } else {
+    DoInsertHinted(first, last, unique);
+  }
 }
 
 template <typename Key, typename T, typename KeyOfT,
@@ -1064,8 +1463,7 @@ void
 rbtree<Key, T, KeyOfT, Compare, Allocator>::DoAssignUnique(
     InputIterator first, InputIterator last) {
   clear();
-  for (; first != last; ++first)
-    DoInsertUnique(end(), *first);
+  DoInsertUnique(first, last);
 }
 
 template <typename Key, typename T, typename KeyOfT,
@@ -1075,8 +1473,165 @@ void
 rbtree<Key, T, KeyOfT, Compare, Allocator>::DoAssignMulti(
     InputIterator first, InputIterator last) {
   clear();
-  for (; first != last; ++first)
-    DoInsertMulti(end(), *first);
+  DoInsertMulti(first, last);
+}
+
+// Forward iterators can be walked twice: when the tree is empty and the
+// range turns out to be sorted, the tree is built directly in O(n).
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename InputIterator>
+void
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertRange(
+    InputIterator first, InputIterator last, bool unique, std::true_type) {
+  size_type n = 0;
+
+  if (empty() && DoCountSorted(first, last, unique, n))
+    DoBuildSorted(first, last, n, unique);
+  else
+    DoInsertHinted(first, last, unique);
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename InputIterator>
+inline void
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertRange(
+    InputIterator first, InputIterator last, bool unique, std::false_type) {
+  DoInsertHinted(first, last, unique);
+}
+
+// Each element is inserted with the successor of the previous one as hint,
+// so a sorted run costs O(1) comparisons per element whatever the tree
+// already holds. For unsorted input the hint fails and the insertion falls
+// back to a search from the root.
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename InputIterator>
+void
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertHinted(
+    InputIterator first, InputIterator last, bool unique) {
+  const_iterator hint = end();
+
+  for (; first != last; ++first) {
+    iterator it = unique ? DoInsertUnique(hint, *first)
+                         : DoInsertMulti(hint, *first);
+    hint = ++it;
+  }
+}
+
+// Returns false if [first, last) is not sorted, otherwise sets n to the
+// number of elements to insert (equal keys counted once if unique).
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename ForwardIterator>
+bool
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoCountSorted(
+    ForwardIterator first, ForwardIterator last, bool unique,
+    size_type& n) const {
+  n = 0;
+  if (first == last)
+    return true;
+
+  ForwardIterator prev = first;
+  n = 1;
+
+  for (++first; first != last; prev = first, ++first) {
+    if (mImpl.KeyCompare(KeyOfT()(*first), KeyOfT()(*prev)))
+      return false;
+    if (!unique || mImpl.KeyCompare(KeyOfT()(*prev), KeyOfT()(*first)))
+      ++n;
+  }
+  return true;
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename ForwardIterator>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::size_type
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoCount(
+    ForwardIterator first, ForwardIterator last, bool unique) const {
+  size_type n = 0;
+
+  for (; first != last; DoNextSorted(first, last, unique))
+    ++n;
+  return n;
+}
+
+// Advances first to the next element to insert, skipping the keys equal to
+// the current one if unique.
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename ForwardIterator>
+inline void
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoNextSorted(
+    ForwardIterator& first, ForwardIterator last, bool unique) const {
+  ForwardIterator prev = first;
+
+  ++first;
+  if (unique) {
+    while (first != last &&
+           !mImpl.KeyCompare(KeyOfT()(*prev), KeyOfT()(*first)))
+      ++first;
+  }
+}
+
+// Builds a tree of the n elements of the sorted range, the tree must be
+// empty. Nodes are created in key order.
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename ForwardIterator>
+void
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoBuildSorted(
+    ForwardIterator first, ForwardIterator last, size_type n, bool unique) {
+  if (n == 0)
+    return;
+
+  // Every level is full except maybe the deepest one, whose nodes are
+  // colored red so that all paths hold the same number of black nodes.
+  size_type redDepth = 0;
+  while ((n >> (redDepth + 1)) != 0)
+    ++redDepth;
+
+  node_type* const pRoot = DoBuildSortedTree(first, last, n, 0, redDepth,
+                                             unique);
+  pRoot->mParent = &mImpl.mHeader;
+  pRoot->mColor  = mBlack;
+
+  mRoot()      = pRoot;
+  mLeftMost()  = sMinimum(mRoot());
+  mRightMost() = sMaximum(mRoot());
+  mImpl.mSize  = n;
+}
+
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+template <typename ForwardIterator>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::node_type*
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoBuildSortedTree(
+    ForwardIterator& first, ForwardIterator last, size_type n,
+    size_type depth, size_type redDepth, bool unique) {
+  if (n == 0)
+    return nullptr;
+
+  const size_type nLeft = (n - 1) / 2;
+
+  node_type* const pLeft = DoBuildSortedTree(first, last, nLeft, depth + 1,
+                                             redDepth, unique);
+  node_type* const pNode = DoCreateNode(*first);
+  DoNextSorted(first, last, unique);
+
+  pNode->mLeft  = pLeft;
+  pNode->mColor = (depth == redDepth) ? mRed : mBlack;
+  if (pLeft != nullptr)
+    pLeft->mParent = pNode;
+
+  pNode->mRight = DoBuildSortedTree(first, last, n - 1 - nLeft, depth + 1,
+                                    redDepth, unique);
+  if (pNode->mRight != nullptr)
+    pNode->mRight->mParent = pNode;
+
+  return pNode;
 }
 
 
@@ -1086,9 +1641,10 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::DoAssignMulti(
 // If not set parent to parent of null leaf and return null (key not found)
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
+template <typename K>
 typename rbtree<Key, T, KeyOfT, Compare, Allocator>::node_base_type*
 rbtree<Key, T, KeyOfT, Compare, Allocator>::FindEqual(
-    node_base_type_ptr& pParent, const key_type& key) {
+    node_base_type_ptr& pParent, const K& key) {
   node_type* child = mBegin();
   bool leftside = true;
   pParent = mEnd();
@@ -1148,9 +1704,10 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::FindMulti(
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
+template <typename K>
 typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
 rbtree<Key, T, KeyOfT, Compare, Allocator>::LowerBound(
-    node_type* x, node_type* y, const key_type& key) {
+    node_type* x, node_type* y, const K& key) {
 
   while (x != nullptr) {
     if (!mImpl.KeyCompare(sKey(x), key)) {
@@ -1165,9 +1722,10 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::LowerBound(
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
+template <typename K>
 typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator
 rbtree<Key, T, KeyOfT, Compare, Allocator>::LowerBound(
-    const node_type* x, const node_type* y, const key_type& key) const {
+    const node_type* x, const node_type* y, const K& key) const {
 
   while (x != nullptr) {
     if (!mImpl.KeyCompare(sKey(x), key)) {
@@ -1182,9 +1740,10 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::LowerBound(
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
+template <typename K>
 typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
 rbtree<Key, T, KeyOfT, Compare, Allocator>::UpperBound(
-    node_type* x, node_type* y, const key_type& key) {
+    node_type* x, node_type* y, const K& key) {
 
   while (x != nullptr) {
     if (mImpl.KeyCompare(key, sKey(x))) {
@@ -1199,9 +1758,10 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::UpperBound(
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
+template <typename K>
 typename rbtree<Key, T, KeyOfT, Compare, Allocator>::const_iterator
 rbtree<Key, T, KeyOfT, Compare, Allocator>::UpperBound(
-    const node_type* x, const node_type* y, const key_type& key) const {
+    const node_type* x, const node_type* y, const K& key) const {
 
   while (x != nullptr) {
     if (mImpl.KeyCompare(key, sKey(x))) {
@@ -1216,9 +1776,10 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::UpperBound(
 
 
 // Find lower bound (parent that is <= key)
-// Leaf will always be null
 // Set parent to parent of null leaf
-// Return reference to null leaf
+// Return null if the leaf is the right child of parent, parent otherwise:
+// DoInsert links the new node on the left when given a non null leaf, which
+// is needed when key is equal to the parent's key.
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
 typename rbtree<Key, T, KeyOfT, Compare, Allocator>::node_base_type*
@@ -1226,24 +1787,24 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::FindLeafLow(
     node_base_type_ptr& pParent, const  key_type& key) {
   node_type* child = mBegin();
   node_type* y = mEnd();
+  bool leftside = true;
 
   while (child != nullptr) {
     y = child;
-    if (mImpl.KeyCompare(sKey(child), key))
-      child = sRight(child);
-    else
-      child = sLeft(child);
+    leftside = !mImpl.KeyCompare(sKey(child), key);
+    child = leftside ? sLeft(child) : sRight(child);
   }
   pParent = static_cast<node_base_type_ptr>(y);
-  return static_cast<node_base_type*>(child);
+  return leftside ? pParent : nullptr;
 }
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
+template <typename K>
 typename rbtree<Key, T, KeyOfT, Compare, Allocator>::node_base_type*
 rbtree<Key, T, KeyOfT, Compare, Allocator>::FindEqual(
     const_iterator hint, node_base_type_ptr& pParent,
-    node_base_type_ptr& dummy, const  key_type& key) {
+    node_base_type_ptr& dummy, const K& key) {
   if (hint == end()) {
     if (size() > 0 && mImpl.KeyCompare(sKey(mRightMost()), key)) {
       pParent = mRightMost();
@@ -1309,8 +1870,8 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::FindLeaf(
       if (hint.mNode->mLeft == nullptr) {
         pParent = static_cast<node_base_type_ptr>(
             const_cast<node_type*>(hint.mNode));
-        return pParent->mLeft;  // nullptr insert will then put it to the left
-                                // if key < hint or right if key == hint;
+        return pParent;  // non null, DoInsert links the node on the left
+                         // even if key == *hint
       } else {
         pParent = static_cast<node_base_type_ptr>(
             const_cast<node_type*>(prior.mNode));
@@ -1326,13 +1887,20 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::FindLeaf(
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
-typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+template <typename... Args>
+inline typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
 rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsert(
-    node_base_type* pParent, node_base_type* x, const value_type& value) {
-  bool insert_left = (x != 0 || pParent == mEnd() ||
-                      mImpl.KeyCompare(KeyOfT()(value), sKey(pParent)));
+    node_base_type* pParent, node_base_type* x, Args&&... args) {
+  return DoInsertNode(pParent, x, DoCreateNode(LIB::forward<Args>(args)...));
+}
 
-  node_type* pNew = DoCreateNode(value);
+template <typename Key, typename T, typename KeyOfT,
+          typename Compare, typename Allocator>
+typename rbtree<Key, T, KeyOfT, Compare, Allocator>::iterator
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoInsertNode(
+    node_base_type* pParent, node_base_type* x, node_type* pNew) {
+  bool insert_left = (x != 0 || pParent == mEnd() ||
+                      mImpl.KeyCompare(sKey(pNew), sKey(pParent)));
 
   RBTreeInsert(pNew, pParent, &mImpl.mHeader, insert_left);
 
@@ -1357,15 +1925,16 @@ rbtree<Key, T, KeyOfT, Compare, Allocator>::DoFreeNode(
 
 template <typename Key, typename T, typename KeyOfT,
           typename Compare, typename Allocator>
+template <typename... Args>
 inline typename rbtree<Key, T, KeyOfT, Compare, Allocator>::node_type*
-rbtree<Key, T, KeyOfT, Compare, Allocator>::DoCreateNode(
-    const value_type& value) {
+rbtree<Key, T, KeyOfT, Compare, Allocator>::DoCreateNode(Args&&... args) {
   node_type* const pNew = DoAllocateNode();
 
 #if JNSTL_EXCEPTIONS_ENABLED
   try {
 #endif
-    ::new(static_cast<void*>(&pNew->mValue)) value_type(value);
+    ::new(static_cast<void*>(&pNew->mValue))
+        value_type(LIB::forward<Args>(args)...);
 
 #if JNSTL_EXCEPTIONS_ENABLED
   } catch (...) {
@@ -1494,7 +2063,7 @@ template <typename Key, typename T, typename KeyOfT,
 inline bool
 operator==(const rbtree<Key, T, KeyOfT, Compare, Allocator>& a,
            const rbtree<Key, T, KeyOfT, Compare, Allocator>& b) {
-  return a.size() == b.size() && equal(a.begin(), a.end(), b.begin());
+  return a.size() == b.size() && jnstl::equal(a.begin(), a.end(), b.begin());
 }
 
 template <typename Key, typename T, typename KeyOfT,
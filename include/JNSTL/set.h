@@ -52,6 +52,16 @@ class set {
     mT.DoInsertUnique(first, last);
   }
 
+  // [first, last) must be sorted by compare, without duplicate keys. The
+  // tree is then built in linear time.
+  template<typename InputIterator>
+  set(sorted_unique_t, InputIterator first, InputIterator last,
+      const Compare& compare = Compare(),
+      const allocator_type& a = allocator_type())
+      : mT(compare, a) {
+    mT.DoInsertSorted(first, last, true);
+  }
+
   set(const set& x)
       : mT(x.mT) {}
 
@@ -134,7 +144,7 @@ class set {
   }
 
   jnstl::pair<iterator, bool>
-  insert(const value_type&& x) {
+  insert(value_type&& x) {
     jnstl::pair<typename rep_type::iterator, bool> p =
         mT.DoInsertUnique(LIB::move(x));
     return jnstl::pair<iterator, bool>(p.first, p.second);
@@ -146,7 +156,7 @@ class set {
   }
 
   iterator
-  insert(const_iterator position, const value_type&& x) {
+  insert(const_iterator position, value_type&& x) {
     return mT.DoInsertUnique(position, LIB::move(x));
   }
 
@@ -156,11 +166,31 @@ class set {
     mT.DoInsertUnique(first, last);
   }
 
+  template<typename InputIterator>
+  void
+  insert(sorted_unique_t, InputIterator first, InputIterator last) {
+    mT.DoInsertSorted(first, last, true);
+  }
+
   void
   insert(std::initializer_list<value_type> ilist) {
     this->insert(ilist.begin(), ilist.end());
   }
 
+  template <typename... Args>
+  jnstl::pair<iterator, bool>
+  emplace(Args&&... args) {
+    jnstl::pair<typename rep_type::iterator, bool> p =
+        mT.DoEmplaceUnique(LIB::forward<Args>(args)...);
+    return jnstl::pair<iterator, bool>(p.first, p.second);
+  }
+
+  template <typename... Args>
+  iterator
+  emplace_hint(const_iterator position, Args&&... args) {
+    return mT.DoEmplaceUniqueHint(position, LIB::forward<Args>(args)...);
+  }
+
   iterator
   erase(const_iterator position) {
     return mT.erase(position);
@@ -226,6 +256,71 @@ class set {
     return mT.equal_range(x);
   }
 
+  // Lookup with any type comparable to key_type, when key_compare is
+  // transparent (e.g. std::less<>). No temporary key is constructed.
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  size_type
+  count(const K& x) const {
+    return mT.find(x) == mT.end() ? 0 : 1;
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  find(const K& x) {
+    return mT.find(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  find(const K& x) const {
+    return mT.find(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  lower_bound(const K& x) {
+    return mT.lower_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  lower_bound(const K& x) const {
+    return mT.lower_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  iterator
+  upper_bound(const K& x) {
+    return mT.upper_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  const_iterator
+  upper_bound(const K& x) const {
+    return mT.upper_bound(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  jnstl::pair<iterator, iterator>
+  equal_range(const K& x) {
+    return mT.equal_range(x);
+  }
+
+  template <typename K, typename C = key_compare,
+            typename = typename C::is_transparent>
+  jnstl::pair<const_iterator, const_iterator>
+  equal_range(const K& x) const {
+    return mT.equal_range(x);
+  }
+
   bool
   validate() const {
     return mT.validate();
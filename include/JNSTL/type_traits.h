@@ -1,6 +1,8 @@
 #ifndef JNSTL_TYPE_TRAITS_H_
 #define JNSTL_TYPE_TRAITS_H_
 
+#include <type_traits>
+
 #include "JNSTL/bits/config.h"
 
 namespace jnstl {
@@ -28,6 +30,18 @@ template <typename Iterator>
 struct is_move_iterator<move_iterator<Iterator>>
     : public std::true_type {};
 
+/**
+ * Types whose objects can be moved to a new address with a plain memcpy,
+ * the source being released without running its destructor.
+ * Trivially copyable types are detected automatically, other types (e.g.
+ * unique_ptr-like handles or small strings not pointing into themselves) can
+ * opt in by specializing this trait to true_type.
+ */
+template <typename T>
+struct is_trivially_relocatable
+    : public std::integral_constant<bool,
+                                    std::is_trivially_copyable<T>::value> {};
+
 }  // namespace jnstl
 
 #endif /* JNSTL_TYPE_TRAITS_H_ */
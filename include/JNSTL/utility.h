@@ -1,7 +1,10 @@
 #ifndef JNSTL_UTILITY_H_
 #define JNSTL_UTILITY_H_
 
+#include <cstddef>
 #include <functional>
+#include <tuple>
+#include <utility>
 
 #include "JNSTL/bits/config.h"
 
@@ -50,9 +53,34 @@ struct pair {
   pair(const first_type& x, const second_type& y)
       : first(x), second(y) {}
 
+  template <typename U, typename V>
+  pair(U&& x, V&& y)
+      : first(LIB::forward<U>(x)), second(LIB::forward<V>(y)) {}
+
   template <typename U, typename V>
   pair(const pair<U, V>& p)
       : first(p.first), second(p.second) {}
+
+  template <typename U, typename V>
+  pair(pair<U, V>&& p)
+      : first(LIB::forward<U>(p.first)), second(LIB::forward<V>(p.second)) {}
+
+  /* Constructs first and second in place from the elements of each tuple,
+     as std::pair does. */
+  template <typename... Args1, typename... Args2>
+  pair(std::piecewise_construct_t,
+       std::tuple<Args1...> args1, std::tuple<Args2...> args2)
+      : pair(args1, args2,
+             std::index_sequence_for<Args1...>(),
+             std::index_sequence_for<Args2...>()) {}
+
+ private:
+  template <typename... Args1, typename... Args2,
+            size_t... Indexes1, size_t... Indexes2>
+  pair(std::tuple<Args1...>& args1, std::tuple<Args2...>& args2,
+       std::index_sequence<Indexes1...>, std::index_sequence<Indexes2...>)
+      : first(LIB::forward<Args1>(std::get<Indexes1>(args1))...),
+        second(LIB::forward<Args2>(std::get<Indexes2>(args2))...) {}
 };
 
 template <typename T1, typename T2>
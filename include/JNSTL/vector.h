@@ -2,6 +2,7 @@
 #define JNSTL_VECTOR_H_
 
 #include <cstddef>
+#include <cstring>
 #include <utility>
 #include <type_traits>
 #include <algorithm>
@@ -18,9 +19,80 @@
 #include "JNSTL/allocator.h"
 #include "JNSTL/iterator.h"
 #include "JNSTL/memory.h"
+#include "JNSTL/type_traits.h"
 
 namespace jnstl {
-template<typename T, typename Allocator>
+/**
+ * @brief Growth policies of vector.
+ *
+ * new_capacity(current, required, elementSize) returns the capacity to
+ * allocate when a vector holding @p current elements needs room for at least
+ * @p required elements of @p elementSize bytes. The result is never less
+ * than @p required.
+ */
+
+/* Grows by half of the current capacity. A freed block can be reused by a
+   later growth, which plays well with realloc and most malloc's. */
+struct vector_growth_1_5x {
+  static size_t new_capacity(size_t current, size_t required, size_t) {
+    const size_t grown = (current > 0) ? current + current / 2 : 1;
+    return (grown > required) ? grown : required;
+  }
+};
+
+/* Doubles the capacity, fewer reallocations at the cost of memory. */
+struct vector_growth_2x {
+  static size_t new_capacity(size_t current, size_t required, size_t) {
+    const size_t grown = (current > 0) ? current * 2 : 1;
+    return (grown > required) ? grown : required;
+  }
+};
+
+/* Grows by 1.5x and, once the buffer spans a page, rounds it up to whole
+   pages: the slack of large buffers would otherwise be wasted by a page
+   granular allocator. Smaller buffers are left as they are. */
+template <size_t PageSize = 4096>
+struct vector_growth_page {
+  static_assert(PageSize != 0 && (PageSize & (PageSize - 1)) == 0,
+                "PageSize must be a power of two");
+
+  static size_t new_capacity(size_t current, size_t required,
+                             size_t elementSize) {
+    const size_t n = vector_growth_1_5x::new_capacity(current, required, 0);
+
+    if (n * elementSize < PageSize)
+      return n;
+
+    const size_t bytes = (n * elementSize + PageSize - 1) & ~(PageSize - 1);
+    return bytes / elementSize;
+  }
+};
+
+/* Grows by 1.5x and rounds the buffer up to the size classes of jemalloc
+   like allocators (four classes per power of two), so that the slack the
+   allocator hands out anyway is usable capacity. */
+struct vector_growth_size_class {
+  static size_t new_capacity(size_t current, size_t required,
+                             size_t elementSize) {
+    const size_t n = vector_growth_1_5x::new_capacity(current, required, 0);
+    return sRoundUp(n * elementSize) / elementSize;
+  }
+
+ private:
+  static size_t sRoundUp(size_t bytes) {
+    if (bytes <= 16)
+      return 16;
+
+    size_t log2 = 0;
+    for (size_t v = bytes - 1; v > 1; v >>= 1)
+      ++log2;
+
+    const size_t spacing = size_t(1) << (log2 - 2);
+    return (bytes + spacing - 1) & ~(spacing - 1);
+  }
+};
+
+template <typename T, typename Allocator, typename GrowthPolicy>
 struct VectorBase {
   typedef Allocator allocator_type;
   typedef size_t    size_type;
@@ -48,14 +120,15 @@ struct VectorBase {
  protected:
   T*        DoAllocate(size_type n);
   void      DoFree(T* p, size_type n);
-  size_type GetNewCapacity(size_type current);
+  size_type GetNewCapacity(size_type current, size_type required);
 };
 
 
-template <typename T, typename Allocator = jnstl::allocator>
-class vector : private VectorBase<T, Allocator> {
-  typedef VectorBase<T, Allocator>                base_type;
-  typedef vector<T, Allocator>                    this_type;
+template <typename T, typename Allocator = jnstl::allocator,
+          typename GrowthPolicy = jnstl::vector_growth_1_5x>
+class vector : private VectorBase<T, Allocator, GrowthPolicy> {
+  typedef VectorBase<T, Allocator, GrowthPolicy> base_type;
+  typedef vector<T, Allocator, GrowthPolicy>     this_type;
 
  public:
   typedef T                                       value_type;
@@ -154,10 +227,10 @@ class vector : private VectorBase<T, Allocator> {
 
   void     pop_back();
 
-  void     emplace_back(const value_type&  value);
-  void     emplace_back(      value_type&& value);
-  iterator emplace(const_iterator position, const value_type&  value);
-  iterator emplace(const_iterator position,       value_type&& value);
+  template <typename... Args>
+  reference emplace_back(Args&&... args);
+  template <typename... Args>
+  iterator  emplace(const_iterator position, Args&&... args);
 
   template <typename InputIterator>
   void assign(InputIterator first, InputIterator last);
@@ -231,107 +304,132 @@ class vector : private VectorBase<T, Allocator> {
                                 jnstl::bidirectional_iterator_tag);
 
   void     DoInsertValue(const_iterator position, const value_type& value);
+  template <typename... Args>
+  void     DoInsertValue(const_iterator position, Args&&... args);
   iterator DoInsertValues(const_iterator position, size_type n,
                           const value_type& value);
 
-  void DoInsertValueEnd(const value_type& value);
-  void DoInsertValueEnd(value_type&& value);
+  template <typename... Args>
+  void DoInsertValueEnd(Args&&... args);
   void DoInsertValuesEnd(size_type n, const value_type& value);
 
   void DoGrow(size_type n);
   void DoSwap(this_type& rhs);
+
+  pointer DoRelocate(pointer pDest);
+  pointer DoRelocate(pointer pDest, std::true_type);
+  pointer DoRelocate(pointer pDest, std::false_type);
+  void    DoReallocate(size_type n);
+  bool    DoIsInternal(const void* p) const;
+  template <typename... Args>
+  bool    DoIsAnyInternal(const Args&... args) const;
+
+  /* Growth can resize the buffer in place with realloc() */
+  static const bool kCanRealloc =
+      jnstl::is_trivially_relocatable<T>::value &&
+      jnstl::is_realloc_allocator<Allocator>::value &&
+      alignof(T) <= JNSTL_MALLOC_ALIGNMENT;
 };
 
 
 // VectorBase //
 
-template <typename T, typename Allocator>
-inline VectorBase<T, Allocator>::VectorBase()
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline VectorBase<T, Allocator, GrowthPolicy>::VectorBase()
     : mBegin(nullptr),
       mEnd(nullptr),
       mCapacity(nullptr),
       mAllocator() {}
 
-template <typename T, typename Allocator>
-inline VectorBase<T, Allocator>::VectorBase(const allocator_type& allocator)
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline
+VectorBase<T, Allocator, GrowthPolicy>::VectorBase(
+    const allocator_type& allocator)
     : mBegin(nullptr),
       mEnd(nullptr),
       mCapacity(nullptr),
       mAllocator(allocator) {}
 
-template <typename T, typename Allocator>
-inline VectorBase<T, Allocator>::VectorBase(size_type n,
-                                            const allocator_type& allocator)
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline
+VectorBase<T, Allocator, GrowthPolicy>::VectorBase(
+    size_type n, const allocator_type& allocator)
     : mAllocator(allocator) {
   mBegin = DoAllocate(n);
   mEnd = mBegin;
   mCapacity = mBegin + n;
 }
 
-template <typename T, typename Allocator>
-inline VectorBase<T, Allocator>::~VectorBase() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline VectorBase<T, Allocator, GrowthPolicy>::~VectorBase() {
   if (mBegin != nullptr)
     mAllocator.deallocate(static_cast<void *>(mBegin),
                           (mCapacity - mBegin) * sizeof(T));
 }
 
 #if 0
-template <typename T, typename Allocator>
-inline const typename VectorBase<T, Allocator>::allocator_type&
-VectorBase<T, Allocator>::get_allocator() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline const typename VectorBase<T, Allocator, GrowthPolicy>::allocator_type&
+VectorBase<T, Allocator, GrowthPolicy>::get_allocator() const {
   return mAllocator;
 }
 
-template <typename T, typename Allocator>
-inline typename VectorBase<T, Allocator>::allocator_type&
-VectorBase<T, Allocator>::get_allocator() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename VectorBase<T, Allocator, GrowthPolicy>::allocator_type&
+VectorBase<T, Allocator, GrowthPolicy>::get_allocator() {
   return mAllocator;
 }
 
-template <typename T, typename Allocator>
-inline void VectorBase<T, Allocator>::set_allocator(
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void VectorBase<T, Allocator, GrowthPolicy>::set_allocator(
     const allocator_type& allocator) {
   mAllocator = allocator;
 }
 #endif
 
-template <typename T, typename Allocator>
-inline T* VectorBase<T, Allocator>::DoAllocate(size_type n) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline T* VectorBase<T, Allocator, GrowthPolicy>::DoAllocate(size_type n) {
+  /* Over-aligned types need more than what malloc guarantees */
+  if (alignof(T) > JNSTL_MALLOC_ALIGNMENT)
+    return static_cast<T*>(mAllocator.allocate(n * sizeof(T), alignof(T), 0));
+
   return static_cast<T*>(mAllocator.allocate(n * sizeof(T)));
 }
 
-template <typename T, typename Allocator>
-inline void VectorBase<T, Allocator>::DoFree(T* p, size_type n) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void VectorBase<T, Allocator, GrowthPolicy>::DoFree(T* p, size_type n) {
   mAllocator.deallocate(static_cast<void *>(p), n * sizeof(T));
 }
 
-template <typename T, typename Allocator>
-inline typename VectorBase<T, Allocator>::size_type
-VectorBase<T, Allocator>::GetNewCapacity(size_type current) {
-  return (size_type)(current > 0) ? (1.5 * current) : 1;
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename VectorBase<T, Allocator, GrowthPolicy>::size_type
+VectorBase<T, Allocator, GrowthPolicy>::GetNewCapacity(size_type current,
+                                                       size_type required) {
+  return GrowthPolicy::new_capacity(current, required, sizeof(T));
 }
 
 
 // Vector //
 
-template <typename T, typename Allocator>
-inline vector<T, Allocator>::vector()
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline vector<T, Allocator, GrowthPolicy>::vector()
     : base_type() {}
 
-template <typename T, typename Allocator>
-inline vector<T, Allocator>::vector(const allocator_type& allocator)
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline
+vector<T, Allocator, GrowthPolicy>::vector(const allocator_type& allocator)
     : base_type(allocator) {}
 
-template <typename T, typename Allocator>
-inline vector<T, Allocator>::vector(size_type n,
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline vector<T, Allocator, GrowthPolicy>::vector(size_type n,
                                     const allocator_type& allocator)
     : base_type(n, allocator) {
   jnstl::uninitialized_default_fill(mBegin, mBegin + n);
   mEnd = mBegin + n;
 }
 
-template <typename T, typename Allocator>
-inline vector<T, Allocator>::vector(size_type n,
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline vector<T, Allocator, GrowthPolicy>::vector(size_type n,
                                     const value_type& value,
                                     const allocator_type& allocator)
     : base_type(n, allocator) {
@@ -339,64 +437,68 @@ inline vector<T, Allocator>::vector(size_type n,
   mEnd = mBegin + n;
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename InputIterator>
-inline vector<T, Allocator>::vector(InputIterator first, InputIterator last,
-                                    const allocator_type& allocator)
+inline
+vector<T, Allocator, GrowthPolicy>::vector(InputIterator first,
+                                           InputIterator last,
+                                           const allocator_type& allocator)
     : base_type(allocator) {
   DoInit(first, last, std::is_integral<InputIterator>());
 }
 
-template <typename T, typename Allocator>
-inline vector<T, Allocator>::vector(const this_type& rhs)
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline vector<T, Allocator, GrowthPolicy>::vector(const this_type& rhs)
     : base_type(rhs.size(), rhs.mAllocator) {
   mEnd = jnstl::uninitialized_copy(rhs.mBegin, rhs.mEnd, mBegin);
 }
 
-template <typename T, typename Allocator>
-inline vector<T, Allocator>::vector(const this_type& rhs,
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline vector<T, Allocator, GrowthPolicy>::vector(const this_type& rhs,
                                     const allocator_type& allocator)
     : base_type(rhs.size(), allocator) {
   mEnd = jnstl::uninitialized_copy(rhs.mBegin, rhs.mEnd, mBegin);
 }
 
-template <typename T, typename Allocator>
-inline vector<T, Allocator>::vector(this_type&& rhs)
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline vector<T, Allocator, GrowthPolicy>::vector(this_type&& rhs)
     : base_type(LIB::move(rhs.mAllocator)) {
   DoSwap(rhs);
 }
 
-template <typename T, typename Allocator>
-inline vector<T, Allocator>::vector(this_type&& rhs,
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline vector<T, Allocator, GrowthPolicy>::vector(this_type&& rhs,
                                     const allocator_type& allocator)
     : base_type(allocator) {
   DoSwap(rhs);
 }
 
-template <typename T, typename Allocator>
-inline vector<T, Allocator>::vector(std::initializer_list<value_type> ilist,
-                                    const allocator_type& allocator)
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline
+vector<T, Allocator, GrowthPolicy>::vector(
+    std::initializer_list<value_type> ilist,
+    const allocator_type& allocator)
     : base_type(allocator) {
   DoInit(ilist.begin(), ilist.end(), std::false_type());
 }
 
-template<typename T, typename Allocator>
-vector<T, Allocator>::~vector() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+vector<T, Allocator, GrowthPolicy>::~vector() {
   jnstl::Destruct(mBegin, mEnd);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::this_type&
-vector<T, Allocator>::operator=(const this_type& rhs) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::this_type&
+vector<T, Allocator, GrowthPolicy>::operator=(const this_type& rhs) {
   this_type tmp(rhs);
 
   DoSwap(tmp);
   return *this;
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::this_type&
-vector<T, Allocator>::operator=(this_type&& rhs) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::this_type&
+vector<T, Allocator, GrowthPolicy>::operator=(this_type&& rhs) {
   if (this != &rhs) {
     clear();
     DoSwap(rhs);
@@ -404,26 +506,26 @@ vector<T, Allocator>::operator=(this_type&& rhs) {
   return *this;
 }
 
-template <typename T, typename Allocator>
-inline void vector<T, Allocator>::swap(this_type& rhs) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void vector<T, Allocator, GrowthPolicy>::swap(this_type& rhs) {
   DoSwap(rhs);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::reference
-vector<T, Allocator>::operator[](size_type i) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::reference
+vector<T, Allocator, GrowthPolicy>::operator[](size_type i) {
   return *(mBegin+i);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::const_reference
-vector<T, Allocator>::operator[](size_type i) const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::const_reference
+vector<T, Allocator, GrowthPolicy>::operator[](size_type i) const {
   return *(mBegin+i);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::reference
-vector<T, Allocator>::at(size_type i) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::reference
+vector<T, Allocator, GrowthPolicy>::at(size_type i) {
 #if JNSTL_EXCEPTIONS_ENABLED
   if (i >= size()) {
     throw;
@@ -432,9 +534,9 @@ vector<T, Allocator>::at(size_type i) {
   return (*this)[i];
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::const_reference
-vector<T, Allocator>::at(size_type i) const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::const_reference
+vector<T, Allocator, GrowthPolicy>::at(size_type i) const {
 #if JNSTL_EXCEPTIONS_ENABLED
   if (i >= size()) {
     throw;
@@ -443,85 +545,87 @@ vector<T, Allocator>::at(size_type i) const {
   return (*this)[i];
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::value_type*
-vector<T, Allocator>::data() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::value_type*
+vector<T, Allocator, GrowthPolicy>::data() {
   return mBegin;
 }
 
-template <typename T, typename Allocator>
-inline const typename vector<T, Allocator>::value_type*
-vector<T, Allocator>::data() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline const typename vector<T, Allocator, GrowthPolicy>::value_type*
+vector<T, Allocator, GrowthPolicy>::data() const {
   return mBegin;
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::begin() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::begin() {
   return iterator(mBegin);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::const_iterator
-vector<T, Allocator>::begin() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::const_iterator
+vector<T, Allocator, GrowthPolicy>::begin() const {
   return const_iterator(mBegin);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::end() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::end() {
   return iterator(mEnd);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::const_iterator
-vector<T, Allocator>::end() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::const_iterator
+vector<T, Allocator, GrowthPolicy>::end() const {
   return const_iterator(mEnd);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::reverse_iterator
-vector<T, Allocator>::rbegin() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::reverse_iterator
+vector<T, Allocator, GrowthPolicy>::rbegin() {
   return reverse_iterator(mEnd);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::const_reverse_iterator
-vector<T, Allocator>::rbegin() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::const_reverse_iterator
+vector<T, Allocator, GrowthPolicy>::rbegin() const {
   return const_reverse_iterator(mEnd);;
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::reverse_iterator
-vector<T, Allocator>::rend() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::reverse_iterator
+vector<T, Allocator, GrowthPolicy>::rend() {
   return reverse_iterator(mBegin);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::const_reverse_iterator
-vector<T, Allocator>::rend() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::const_reverse_iterator
+vector<T, Allocator, GrowthPolicy>::rend() const {
   return const_reverse_iterator(mBegin);
 }
 
-template <typename T, typename Allocator>
-bool vector<T, Allocator>::empty() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool vector<T, Allocator, GrowthPolicy>::empty() const {
   return (mBegin == mEnd);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::size_type
-vector<T, Allocator>::size() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::size_type
+vector<T, Allocator, GrowthPolicy>::size() const {
   return (size_type)(mEnd - mBegin);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::size_type
-vector<T, Allocator>::capacity() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::size_type
+vector<T, Allocator, GrowthPolicy>::capacity() const {
   return (size_type)(mCapacity - mBegin);
 }
 
-template <typename T, typename Allocator>
-inline void vector<T, Allocator>::resize(size_type n, const value_type& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void
+vector<T, Allocator, GrowthPolicy>::resize(size_type n,
+                                           const value_type& value) {
   if (n > (size_type)(mEnd - mBegin)) {
     DoInsertValuesEnd(n - (size_type)(mEnd -mBegin),  value);
   } else {
@@ -530,140 +634,130 @@ inline void vector<T, Allocator>::resize(size_type n, const value_type& value) {
   }
 }
 
-template <typename T, typename Allocator>
-inline void vector<T, Allocator>::reserve(size_type n) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void vector<T, Allocator, GrowthPolicy>::reserve(size_type n) {
   if (n > (size_type)(mCapacity - mBegin)) {
     DoGrow(n);
   }
 }
 
-template <typename T, typename Allocator>
-inline void vector<T, Allocator>::shrink_to_fit() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void vector<T, Allocator, GrowthPolicy>::shrink_to_fit() {
   if (mEnd < mCapacity) {
-    this_type tmp(move_iterator<iterator>(begin()),
-                  move_iterator<iterator>(end()), mAllocator);
-
-    DoSwap(tmp);
+    if (mBegin == mEnd) {
+      DoFree(mBegin, (size_type)(mCapacity - mBegin));
+      mBegin    = nullptr;
+      mEnd      = nullptr;
+      mCapacity = nullptr;
+    } else {
+      DoReallocate((size_type)(mEnd - mBegin));
+    }
   }
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::reference
-vector<T, Allocator>::front() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::reference
+vector<T, Allocator, GrowthPolicy>::front() {
   return *mBegin;
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::const_reference
-vector<T, Allocator>::front() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::const_reference
+vector<T, Allocator, GrowthPolicy>::front() const {
   return *mBegin;
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::reference
-vector<T, Allocator>::back() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::reference
+vector<T, Allocator, GrowthPolicy>::back() {
   return *(mEnd - 1);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::const_reference
-vector<T, Allocator>::back() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::const_reference
+vector<T, Allocator, GrowthPolicy>::back() const {
   return *(mEnd - 1);
 }
 
-template <typename T, typename Allocator>
-inline void vector<T, Allocator>::push_back(const value_type& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void
+vector<T, Allocator, GrowthPolicy>::push_back(const value_type& value) {
   if (mEnd < mCapacity)
     jnstl::Construct(LIB::addressof(*mEnd++), value);
   else
     DoInsertValueEnd(value);
 }
 
-template <typename T, typename Allocator>
-inline void vector<T, Allocator>::push_back(value_type&& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void vector<T, Allocator, GrowthPolicy>::push_back(value_type&& value) {
   if (mEnd < mCapacity)
     jnstl::Construct(LIB::addressof(*mEnd++), LIB::move(value));
   else
     DoInsertValueEnd(LIB::move(value));
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 inline void
-vector<T, Allocator>::pop_back() {
+vector<T, Allocator, GrowthPolicy>::pop_back() {
   --mEnd;
   jnstl::Destruct(mEnd);
 }
 
-template <typename T, typename Allocator>
-inline void vector<T, Allocator>::emplace_back(const value_type& value) {
-  if (mEnd < mCapacity)
-    jnstl::Construct(LIB::addressof(*mEnd++), value);
-  else
-    DoInsertValueEnd(value);
-}
-
-template <typename T, typename Allocator>
-inline void vector<T, Allocator>::emplace_back(value_type&& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+inline typename vector<T, Allocator, GrowthPolicy>::reference
+vector<T, Allocator, GrowthPolicy>::emplace_back(Args&&... args) {
   if (mEnd < mCapacity)
-    jnstl::Construct(LIB::addressof(*mEnd++), LIB::move(value));
+    jnstl::Construct(LIB::addressof(*mEnd++), LIB::forward<Args>(args)...);
   else
-    DoInsertValueEnd(LIB::move(value));
-}
+    DoInsertValueEnd(LIB::forward<Args>(args)...);
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::emplace(const_iterator position,
-                              const value_type& value) {
-  const ptrdiff_t n = position - mBegin;
-
-  if ((mEnd == mCapacity) || !(position == mEnd)) {
-    DoInsertValue(position, value);
-  } else {
-    jnstl::Construct(LIB::addressof(*mEnd), value);
-    mEnd++;
-  }
-
-  return mBegin + n;
+  return *(mEnd - 1);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::emplace(const_iterator position,
-                              value_type&& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::emplace(const_iterator position,
+                                            Args&&... args) {
   const ptrdiff_t n = position - mBegin;
 
   if ((mEnd == mCapacity) || !(position == mEnd)) {
-    DoInsertValue(position, LIB::move(value));
+    DoInsertValue(position, LIB::forward<Args>(args)...);
   } else {
-    jnstl::Construct(LIB::addressof(*mEnd), LIB::move(value));
+    jnstl::Construct(LIB::addressof(*mEnd), LIB::forward<Args>(args)...);
     mEnd++;
   }
 
   return mBegin + n;
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename InputIterator>
 inline void
-vector<T, Allocator>::assign(InputIterator first, InputIterator last) {
+vector<T, Allocator, GrowthPolicy>::assign(InputIterator first,
+                                           InputIterator last) {
   DoAssign(first, last, std::is_integral<InputIterator>());
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 inline void
-vector<T, Allocator>::assign(std::initializer_list<value_type> il) {
+vector<T, Allocator, GrowthPolicy>::assign(
+    std::initializer_list<value_type> il) {
   DoAssign(il.begin(), il.end(), std::false_type());
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 inline void
-vector<T, Allocator>::assign(size_type n, const value_type& value) {
+vector<T, Allocator, GrowthPolicy>::assign(size_type n,
+                                           const value_type& value) {
   DoAssignValues(n, value);
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::insert(const_iterator position, const value_type& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::insert(const_iterator position,
+                                           const value_type& value) {
   const ptrdiff_t n = position - mBegin;
 
   if ((mEnd == mCapacity) || !(position == mEnd)) {
@@ -676,9 +770,10 @@ vector<T, Allocator>::insert(const_iterator position, const value_type& value) {
   return mBegin + n;
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::insert(const_iterator position, value_type&& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::insert(const_iterator position,
+                                           value_type&& value) {
   const ptrdiff_t n = position - mBegin;
 
   if ((mEnd == mCapacity) || !(position == mEnd)) {
@@ -691,32 +786,32 @@ vector<T, Allocator>::insert(const_iterator position, value_type&& value) {
   return mBegin + n;
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::insert(const_iterator position, size_type n,
-                             const value_type& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::insert(const_iterator position, size_type n,
+                                           const value_type& value) {
   return DoInsertValues(position, n, value);
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename InputIterator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::insert(const_iterator position,
-                             InputIterator first,
-                             InputIterator last) {
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::insert(const_iterator position,
+                                           InputIterator first,
+                                           InputIterator last) {
   return DoInsert(position, first, last, std::is_integral<InputIterator>());
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::insert(const_iterator position,
-                             std::initializer_list<value_type> il) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::insert(
+    const_iterator position, std::initializer_list<value_type> il) {
   return DoInsert(position, il.begin(), il.end(), std::false_type());
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::erase(const_iterator position) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::erase(const_iterator position) {
   iterator destPosition = const_cast<value_type*>(position);
   if ((position + 1) < mEnd)
     jnstl::move(destPosition + 1, mEnd, destPosition);
@@ -726,9 +821,10 @@ vector<T, Allocator>::erase(const_iterator position) {
   return destPosition;
 }
 
-template <typename T, typename Allocator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::erase(const_iterator first, const_iterator last) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::erase(const_iterator first,
+                                          const_iterator last) {
   iterator const position =
       const_cast<value_type*>(jnstl::move(const_cast<value_type*>(last), mEnd,
                                           const_cast<value_type*>(first)));
@@ -739,14 +835,14 @@ vector<T, Allocator>::erase(const_iterator first, const_iterator last) {
   return const_cast<value_type*>(first);
 }
 
-template <typename T, typename Allocator>
-inline void vector<T, Allocator>::clear() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void vector<T, Allocator, GrowthPolicy>::clear() {
   jnstl::Destruct(mBegin, mEnd);
   mEnd = mBegin;
 }
 
-template <typename T, typename Allocator>
-inline bool vector<T, Allocator>::validate() const {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool vector<T, Allocator, GrowthPolicy>::validate() const {
   if (mEnd < mBegin)
     return false;
   if (mCapacity < mEnd)
@@ -755,9 +851,9 @@ inline bool vector<T, Allocator>::validate() const {
   return true;
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename Integer>
-inline void vector<T, Allocator>::DoInit(Integer n, Integer value,
+inline void vector<T, Allocator, GrowthPolicy>::DoInit(Integer n, Integer value,
                                          std::true_type) {
   mBegin    = DoAllocate((size_type)n);
   mEnd      = mBegin + n;
@@ -765,9 +861,9 @@ inline void vector<T, Allocator>::DoInit(Integer n, Integer value,
   jnstl::uninitialized_fill(mBegin, mBegin + n, value);
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename InputIterator>
-inline void vector<T, Allocator>::DoInit(InputIterator first,
+inline void vector<T, Allocator, GrowthPolicy>::DoInit(InputIterator first,
                                          InputIterator last,
                                          std::false_type) {
   typedef typename
@@ -776,17 +872,17 @@ inline void vector<T, Allocator>::DoInit(InputIterator first,
   DoInitFromIterator(first, last, IC());
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename InputIterator>
-inline void vector<T, Allocator>::DoInitFromIterator(
+inline void vector<T, Allocator, GrowthPolicy>::DoInitFromIterator(
     InputIterator first, InputIterator last, jnstl::input_iterator_tag) {
   for (; first != last; ++first)
     push_back(*first);
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename ForwardIterator>
-inline void vector<T, Allocator>::DoInitFromIterator(
+inline void vector<T, Allocator, GrowthPolicy>::DoInitFromIterator(
     ForwardIterator first, ForwardIterator last,
     jnstl::forward_iterator_tag) {
   const size_type n = static_cast<size_type>(jnstl::distance(first, last));
@@ -795,32 +891,33 @@ inline void vector<T, Allocator>::DoInitFromIterator(
   mEnd = jnstl::uninitialized_copy(first, last, mBegin);
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename Integer>
 inline void
-vector<T, Allocator>::DoAssign(Integer n, Integer value,
-                               std::true_type) {
+vector<T, Allocator, GrowthPolicy>::DoAssign(Integer n, Integer value,
+                                             std::true_type) {
   DoAssignValues(static_cast<size_type>(n), static_cast<value_type>(value));
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename InputIterator>
 inline void
-vector<T, Allocator>::DoAssign(InputIterator first, InputIterator last,
-                               std::false_type) {
+vector<T, Allocator, GrowthPolicy>::DoAssign(InputIterator first,
+                                             InputIterator last,
+                                             std::false_type) {
   typedef typename
       jnstl::iterator_traits<InputIterator>::iterator_category IC;
 
   DoAssignFromIterator(first, last, IC());
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 void
-vector<T, Allocator>::DoAssignValues(size_type n, const value_type& value) {
+vector<T, Allocator, GrowthPolicy>::DoAssignValues(size_type n,
+                                                   const value_type& value) {
   if (n > static_cast<size_type>(mCapacity - mBegin)) {
     const size_type nPrev = static_cast<size_type>(mEnd - mBegin);
-    const size_type nGrow = GetNewCapacity(nPrev);
-    const size_type nNew  = jnstl::max(nGrow, n);
+    const size_type nNew  = GetNewCapacity(nPrev, n);
 
     pointer const pNewData = DoAllocate(nNew);
 
@@ -843,11 +940,11 @@ vector<T, Allocator>::DoAssignValues(size_type n, const value_type& value) {
   }
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename InputIterator>
 inline void
-vector<T, Allocator>::DoAssignFromIterator(InputIterator first,
-                                           InputIterator last,
+vector<T, Allocator, GrowthPolicy>::DoAssignFromIterator(InputIterator first,
+                                                         InputIterator last,
                                            jnstl::input_iterator_tag) {
   iterator cur = begin();
 
@@ -863,18 +960,17 @@ vector<T, Allocator>::DoAssignFromIterator(InputIterator first,
   }
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename ForwardIterator>
 void
-vector<T, Allocator>::DoAssignFromIterator(ForwardIterator first,
-                                           ForwardIterator last,
+vector<T, Allocator, GrowthPolicy>::DoAssignFromIterator(ForwardIterator first,
+                                                         ForwardIterator last,
                                            jnstl::forward_iterator_tag) {
   const size_type n = static_cast<size_type>(jnstl::distance(first, last));
 
   if (n > static_cast<size_type>(mCapacity - mBegin)) {
     const size_type nPrev = static_cast<size_type>(mEnd - mBegin);
-    const size_type nGrow = GetNewCapacity(nPrev);
-    const size_type nNew  = jnstl::max(nGrow, n);
+    const size_type nNew  = GetNewCapacity(nPrev, n);
 
     pointer const pNewData = DoAllocate(nNew);
     pointer       pNewEnd  = pNewData;
@@ -901,11 +997,11 @@ vector<T, Allocator>::DoAssignFromIterator(ForwardIterator first,
   }
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename Integer>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::DoInsert(const_iterator position,
-                               Integer n, Integer value,
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::DoInsert(const_iterator position,
+                                             Integer n, Integer value,
                                std::true_type) {
   if (n > 0)
     return DoInsertValues(position, static_cast<size_type>(n),
@@ -914,11 +1010,11 @@ vector<T, Allocator>::DoInsert(const_iterator position,
     return iterator(position);
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename InputIterator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::DoInsert(const_iterator position,
-                               InputIterator first,
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::DoInsert(const_iterator position,
+                                             InputIterator first,
                                InputIterator last,
                                std::false_type) {
   typedef typename
@@ -927,26 +1023,28 @@ vector<T, Allocator>::DoInsert(const_iterator position,
   return DoInsertFromIterator(position, first, last, IC());
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename InputIterator>
-inline typename vector<T, Allocator>::iterator
-vector<T, Allocator>::DoInsertFromIterator(const_iterator position,
-                                           InputIterator first,
-                                           InputIterator last,
-                                           jnstl::input_iterator_tag) {
+inline typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::DoInsertFromIterator(
+    const_iterator position,
+    InputIterator first,
+    InputIterator last,
+    jnstl::input_iterator_tag) {
   for (; first != last; ++first, ++position)
     position = insert(position, *first);
 
   return position;
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename BidirectionalIterator>
-typename vector<T, Allocator>::iterator
-vector<T, Allocator>::DoInsertFromIterator(const_iterator position,
-                                           BidirectionalIterator first,
-                                           BidirectionalIterator last,
-                                           jnstl::bidirectional_iterator_tag) {
+typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::DoInsertFromIterator(
+    const_iterator position,
+    BidirectionalIterator first,
+    BidirectionalIterator last,
+    jnstl::bidirectional_iterator_tag) {
   iterator destPosition = const_cast<value_type*>(position);
 
   if (first != last) {
@@ -970,8 +1068,7 @@ vector<T, Allocator>::DoInsertFromIterator(const_iterator position,
       mEnd += n;
     } else {
       const size_type nPrev = (size_type)(mEnd - mBegin);
-      const size_type nGrow = GetNewCapacity(nPrev);
-      const size_type nNew  = jnstl::max(nGrow, n);
+      const size_type nNew  = GetNewCapacity(nPrev, nPrev + n);
 
       pointer const pNewData = DoAllocate(nNew);
 
@@ -992,8 +1089,8 @@ vector<T, Allocator>::DoInsertFromIterator(const_iterator position,
   return mEnd;
 }
 
-template <typename T, typename Allocator>
-void vector<T, Allocator>::DoInsertValue(const_iterator position,
+template <typename T, typename Allocator, typename GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::DoInsertValue(const_iterator position,
                                          const value_type& value) {
   iterator destPosition = const_cast<value_type*>(position);
   if (mEnd != mCapacity) {
@@ -1010,8 +1107,7 @@ void vector<T, Allocator>::DoInsertValue(const_iterator position,
     ++mEnd;
   } else {
     const size_type nPrev = (size_type)(mEnd - mBegin);
-    const size_type nGrow = GetNewCapacity(nPrev);
-    const size_type nNew  = jnstl::max(nGrow, nPrev + 1);
+    const size_type nNew  = GetNewCapacity(nPrev, nPrev + 1);
 
     pointer const pNewData = DoAllocate(nNew);
 
@@ -1034,10 +1130,50 @@ void vector<T, Allocator>::DoInsertValue(const_iterator position,
   }
 }
 
-template <typename T, typename Allocator>
-typename vector<T, Allocator>::iterator
-vector<T, Allocator>::DoInsertValues(const_iterator position,
-                                     size_type n,
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+void vector<T, Allocator, GrowthPolicy>::DoInsertValue(const_iterator position,
+                                                       Args&&... args) {
+  iterator destPosition = const_cast<value_type*>(position);
+  if (mEnd != mCapacity) {
+    /* args may refer to the elements about to be shifted */
+    value_type temp(LIB::forward<Args>(args)...);
+
+    jnstl::Construct(LIB::addressof(*mEnd), LIB::move(*(mEnd - 1)));
+    jnstl::move_backward(destPosition, mEnd - 1, mEnd);
+
+    *destPosition = LIB::move(temp);
+
+    ++mEnd;
+  } else {
+    const size_type nPrev = (size_type)(mEnd - mBegin);
+    const size_type nNew  = GetNewCapacity(nPrev, nPrev + 1);
+
+    pointer const pNewData = DoAllocate(nNew);
+
+    pointer pNewEnd = pNewData;
+
+    jnstl::Construct(LIB::addressof(*(pNewData +
+                                      (size_type)(destPosition - mBegin))),
+                     LIB::forward<Args>(args)...);
+
+    pNewEnd = jnstl::uninitialized_move(mBegin, destPosition, pNewData);
+
+    pNewEnd = jnstl::uninitialized_move(destPosition, mEnd, ++pNewEnd);
+
+    jnstl::Destruct(mBegin, mEnd);
+    DoFree(mBegin, (size_type)(mCapacity - mBegin));
+
+    mBegin    = pNewData;
+    mEnd      = pNewEnd;
+    mCapacity = pNewData + nNew;
+  }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+typename vector<T, Allocator, GrowthPolicy>::iterator
+vector<T, Allocator, GrowthPolicy>::DoInsertValues(const_iterator position,
+                                                   size_type n,
                                      const value_type& value) {
   iterator destPosition = const_cast<value_type*>(position);
 
@@ -1058,8 +1194,7 @@ vector<T, Allocator>::DoInsertValues(const_iterator position,
     mEnd += n;
   } else {
     const size_type nPrev = (size_type)(mEnd - mBegin);
-    const size_type nGrow = GetNewCapacity(nPrev);
-    const size_type nNew  = jnstl::max(nGrow, n + nPrev);
+    const size_type nNew  = GetNewCapacity(nPrev, n + nPrev);
 
     pointer const pNewData = DoAllocate(nNew);
 
@@ -1079,66 +1214,51 @@ vector<T, Allocator>::DoInsertValues(const_iterator position,
   return mEnd;
 }
 
-template <typename T, typename Allocator>
-void vector<T, Allocator>::DoInsertValueEnd(const value_type& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+void vector<T, Allocator, GrowthPolicy>::DoInsertValueEnd(Args&&... args) {
   const size_type nPrev = (size_type)(mEnd - mBegin);
-  const size_type nGrow = GetNewCapacity(nPrev);
-  const size_type nNew  = jnstl::max(nGrow, nPrev + 1);
+  const size_type nNew  = GetNewCapacity(nPrev, nPrev + 1);
 
-  pointer const pNewData = DoAllocate(nNew);
-
-  pointer pNewEnd = jnstl::uninitialized_move(mBegin, mEnd, pNewData);
-
-  jnstl::Construct(LIB::addressof(*pNewEnd++), value);
-
-  jnstl::Destruct(mBegin, mEnd);
-  DoFree(mBegin, (size_type)(mCapacity - mBegin));
-
-  mBegin    = pNewData;
-  mEnd      = pNewEnd;
-  mCapacity = pNewData + nNew;
-}
-
-template <typename T, typename Allocator>
-void vector<T, Allocator>::DoInsertValueEnd(value_type&& value) {
-  const size_type nPrev = (size_type)(mEnd - mBegin);
-  const size_type nGrow = GetNewCapacity(nPrev);
-  const size_type nNew  = jnstl::max(nGrow, nPrev + 1);
+  if (kCanRealloc && !DoIsAnyInternal(args...)) {
+    DoReallocate(nNew);
+    jnstl::Construct(LIB::addressof(*mEnd++), LIB::forward<Args>(args)...);
+    return;
+  }
 
   pointer const pNewData = DoAllocate(nNew);
 
-  pointer pNewEnd = jnstl::uninitialized_move(mBegin, mEnd, pNewData);
+  /* args may refer to elements of this vector, construct the new element
+     before the old ones are relocated. */
+  jnstl::Construct(LIB::addressof(*(pNewData + nPrev)),
+                   LIB::forward<Args>(args)...);
 
-  jnstl::Construct(LIB::addressof(*pNewEnd++), LIB::move(value));
+  pointer pNewEnd = DoRelocate(pNewData);
 
-  jnstl::Destruct(mBegin, mEnd);
   DoFree(mBegin, (size_type)(mCapacity - mBegin));
 
   mBegin    = pNewData;
-  mEnd      = pNewEnd;
+  mEnd      = pNewEnd + 1;
   mCapacity = pNewData + nNew;
 }
 
-template <typename T, typename Allocator>
-void vector<T, Allocator>::DoInsertValuesEnd(size_type n,
+template <typename T, typename Allocator, typename GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::DoInsertValuesEnd(size_type n,
                                              const value_type& value) {
   if (n > (size_type)(mCapacity - mEnd)) {
     const size_type nPrev = (size_type)(mEnd - mBegin);
-    const size_type nGrow = GetNewCapacity(nPrev);
-    const size_type nNew  = jnstl::max(nGrow, nPrev + n);
+    const size_type nNew  = GetNewCapacity(nPrev, nPrev + n);
 
     pointer const pNewData = DoAllocate(nNew);
 
-    pointer pNewEnd = jnstl::uninitialized_move(mBegin, mEnd, pNewData);
+    jnstl::uninitialized_fill(pNewData + nPrev, pNewData + nPrev + n, value);
 
-    jnstl::uninitialized_fill(pNewEnd, pNewEnd + n, value);
-    pNewEnd += n;
+    pointer pNewEnd = DoRelocate(pNewData);
 
-    jnstl::Destruct(mBegin, mEnd);
     DoFree(mBegin, (size_type)(mCapacity - mBegin));
 
     mBegin    = pNewData;
-    mEnd      = pNewEnd;
+    mEnd      = pNewEnd + n;
     mCapacity = pNewData + nNew;
   } else {
     jnstl::uninitialized_fill(mEnd, mEnd + n, value);
@@ -1146,73 +1266,137 @@ void vector<T, Allocator>::DoInsertValuesEnd(size_type n,
   }
 }
 
-template <typename T, typename Allocator>
-void vector<T, Allocator>::DoGrow(size_type n) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::DoGrow(size_type n) {
   const size_type nPrev = (size_type)(mEnd - mBegin);
-  const size_type nGrow = GetNewCapacity(nPrev);
-  const size_type nNew  = jnstl::max(nGrow, n);
+  const size_type nNew  = GetNewCapacity(nPrev, n);
 
-  pointer const pNewData = DoAllocate(nNew);
+  DoReallocate(nNew);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void vector<T, Allocator, GrowthPolicy>::DoSwap(this_type& rhs) {
+  LIB::swap(mBegin,     rhs.mBegin);
+  LIB::swap(mEnd,       rhs.mEnd);
+  LIB::swap(mCapacity,  rhs.mCapacity);
+  LIB::swap(mAllocator, rhs.mAllocator);
+}
+
+/* Moves the elements to pDest, the old range is left destroyed. Returns the
+   end of the new range. */
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::pointer
+vector<T, Allocator, GrowthPolicy>::DoRelocate(pointer pDest) {
+  return DoRelocate(pDest, jnstl::is_trivially_relocatable<T>());
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::pointer
+vector<T, Allocator, GrowthPolicy>::DoRelocate(pointer pDest, std::true_type) {
+  const size_type n = (size_type)(mEnd - mBegin);
+
+  if (n)
+    memcpy(static_cast<void*>(pDest), static_cast<const void*>(mBegin),
+           n * sizeof(T));
+  return pDest + n;
+}
 
-  pointer pNewEnd = jnstl::uninitialized_move(mBegin, mEnd, pNewData);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline typename vector<T, Allocator, GrowthPolicy>::pointer
+vector<T, Allocator, GrowthPolicy>::DoRelocate(pointer pDest, std::false_type) {
+  pointer pDestEnd = jnstl::uninitialized_move(mBegin, mEnd, pDest);
 
   jnstl::Destruct(mBegin, mEnd);
-  DoFree(mBegin, (size_type)(mCapacity - mBegin));
+  return pDestEnd;
+}
+
+/* Moves the elements to a buffer of capacity n >= size() */
+template <typename T, typename Allocator, typename GrowthPolicy>
+void vector<T, Allocator, GrowthPolicy>::DoReallocate(size_type n) {
+  const size_type nSize = (size_type)(mEnd - mBegin);
+  pointer pNewData = nullptr;
+
+  if (kCanRealloc)
+    pNewData = static_cast<pointer>(::realloc(static_cast<void*>(mBegin),
+                                              n * sizeof(T)));
+
+  /* A failed realloc leaves the old buffer as it was, the elements are then
+     moved by hand like those of any other type. */
+  if (pNewData == nullptr) {
+    pNewData = DoAllocate(n);
+    DoRelocate(pNewData);
+    DoFree(mBegin, (size_type)(mCapacity - mBegin));
+  }
 
   mBegin    = pNewData;
-  mEnd      = pNewEnd;
-  mCapacity = pNewData + nNew;
+  mEnd      = pNewData + nSize;
+  mCapacity = pNewData + n;
 }
 
-template <typename T, typename Allocator>
-inline void vector<T, Allocator>::DoSwap(this_type& rhs) {
-  LIB::swap(mBegin,     rhs.mBegin);
-  LIB::swap(mEnd,       rhs.mEnd);
-  LIB::swap(mCapacity,  rhs.mCapacity);
-  LIB::swap(mAllocator, rhs.mAllocator);
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool
+vector<T, Allocator, GrowthPolicy>::DoIsInternal(const void* p) const {
+  const char* const pByte = static_cast<const char*>(p);
+  return (pByte >= reinterpret_cast<const char*>(mBegin)) &&
+         (pByte <  reinterpret_cast<const char*>(mEnd));
+}
+
+/* True when one of args is an element of this vector, or a member of one */
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+inline bool
+vector<T, Allocator, GrowthPolicy>::DoIsAnyInternal(const Args&... args) const {
+  const bool internal[] = {false, DoIsInternal(LIB::addressof(args))...};
+
+  for (size_t i = 0; i < sizeof(internal) / sizeof(internal[0]); ++i) {
+    if (internal[i])
+      return true;
+  }
+  return false;
 }
 
 // Global //
-template <typename T, typename Allocator>
-inline bool operator==(const vector<T, Allocator>& a,
-                       const vector<T, Allocator>& b) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool operator==(const vector<T, Allocator, GrowthPolicy>& a,
+                       const vector<T, Allocator, GrowthPolicy>& b) {
   return ((a.size() == b.size()) &&
           jnstl::equal(a.begin(), a.end(), b.begin()));
 }
 
-template <typename T, typename Allocator>
-inline bool operator<(const vector<T, Allocator>& a,
-                      const vector<T, Allocator>& b) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool operator<(const vector<T, Allocator, GrowthPolicy>& a,
+                      const vector<T, Allocator, GrowthPolicy>& b) {
   return std::lexicographical_compare(a.begin(), a.end(),
                                       b.begin(), b.end());
 }
 
-template <typename T, typename Allocator>
-inline bool operator!=(const vector<T, Allocator>& a,
-                       const vector<T, Allocator>& b) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool operator!=(const vector<T, Allocator, GrowthPolicy>& a,
+                       const vector<T, Allocator, GrowthPolicy>& b) {
   return !(a == b);
 }
 
-template <typename T, typename Allocator>
-inline bool operator>(const vector<T, Allocator>& a,
-                      const vector<T, Allocator>& b) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool operator>(const vector<T, Allocator, GrowthPolicy>& a,
+                      const vector<T, Allocator, GrowthPolicy>& b) {
   return b < a;
 }
 
-template <typename T, typename Allocator>
-inline bool operator<=(const vector<T, Allocator>& a,
-                       const vector<T, Allocator>& b) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool operator<=(const vector<T, Allocator, GrowthPolicy>& a,
+                       const vector<T, Allocator, GrowthPolicy>& b) {
   return !(b < a);
 }
 
-template <typename T, typename Allocator>
-inline bool operator>=(const vector<T, Allocator>& a,
-                       const vector<T, Allocator>& b) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline bool operator>=(const vector<T, Allocator, GrowthPolicy>& a,
+                       const vector<T, Allocator, GrowthPolicy>& b) {
   return !(a < b);
 }
 
-template <typename T, typename Allocator>
-inline void swap(vector<T, Allocator>& a, vector<T, Allocator>& b) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+inline void swap(vector<T, Allocator, GrowthPolicy>& a,
+                 vector<T, Allocator, GrowthPolicy>& b) {
   a.swap(b);
 }
 }  // namespace jnstl
@@ -1,6 +1,6 @@
 
-#include "/home/jeannoel/Algo/jnstl/include/JNSTL/bits/config.h"
-#include "/home/jeannoel/Algo/jnstl/include/JNSTL/red_black_tree.h"
+#include "JNSTL/bits/config.h"
+#include "JNSTL/red_black_tree.h"
 
 namespace jnstl {
 